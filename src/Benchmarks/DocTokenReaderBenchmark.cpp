@@ -0,0 +1,259 @@
+//
+//  DocTokenReaderBenchmark.cpp
+//  MetadataGenerator
+//
+//  Compares TypeScript::DocTokenReader against the libxml2 tree and XPath
+//  queries DocSetManager used to read token files with: the whole document
+//  parsed with xmlReadFile and a new XPath context per query. Both have to
+//  extract the same text from every file. Reports the time per document and
+//  the peak of the memory libxml2 holds while reading one.
+//
+//  Usage: doc-token-reader-benchmark [<docset>/Contents/Resources/Tokens] [iterations]
+//  Without a tokens directory, token files like the ones of the macOS docset are generated.
+//
+
+#include "TypeScript/DocTokenReader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <libxml/parser.h>
+#include <libxml/xpath.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+#include <vector>
+
+using namespace std;
+using namespace TypeScript;
+
+// libxml2 allocations, counted through xmlMemSetup with the size kept in front of every block
+static size_t currentBytes = 0;
+static size_t peakBytes = 0;
+static const size_t headerSize = alignof(max_align_t);
+
+static void* countingMalloc(size_t size)
+{
+    char* block = static_cast<char*>(malloc(size + headerSize));
+    if (!block) {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    currentBytes += size;
+    peakBytes = max(peakBytes, currentBytes);
+    return block + headerSize;
+}
+
+static void countingFree(void* memory)
+{
+    if (!memory) {
+        return;
+    }
+    char* block = static_cast<char*>(memory) - headerSize;
+    currentBytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+static void* countingRealloc(void* memory, size_t size)
+{
+    if (!memory) {
+        return countingMalloc(size);
+    }
+    char* block = static_cast<char*>(memory) - headerSize;
+    size_t oldSize = *reinterpret_cast<size_t*>(block);
+    block = static_cast<char*>(realloc(block, size + headerSize));
+    if (!block) {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    currentBytes = currentBytes - oldSize + size;
+    peakBytes = max(peakBytes, currentBytes);
+    return block + headerSize;
+}
+
+static char* countingStrdup(const char* s)
+{
+    size_t size = strlen(s) + 1;
+    char* copy = static_cast<char*>(countingMalloc(size));
+    if (copy) {
+        memcpy(copy, s, size);
+    }
+    return copy;
+}
+
+// The previous DocSetManager extraction
+static vector<string> allTextOf(const char* xpath, xmlDocPtr doc)
+{
+    vector<string> texts;
+    xmlXPathContextPtr context = xmlXPathNewContext(doc);
+    xmlXPathObjectPtr result = xmlXPathEvalExpression(reinterpret_cast<const xmlChar*>(xpath), context);
+    xmlXPathFreeContext(context);
+    if (!xmlXPathNodeSetIsEmpty(result->nodesetval)) {
+        for (int i = 0; i < result->nodesetval->nodeNr; ++i) {
+            char* innerText = reinterpret_cast<char*>(xmlNodeGetContent(result->nodesetval->nodeTab[i]));
+            texts.push_back(innerText);
+            xmlFree(innerText);
+        }
+    }
+    xmlXPathFreeObject(result);
+    return texts;
+}
+
+static bool readWithXPath(const string& path, DocToken& token)
+{
+    xmlDocPtr doc = xmlReadFile(path.c_str(), nullptr, 0);
+    if (!doc) {
+        return false;
+    }
+    vector<string> abstracts = allTextOf("/*/Abstract", doc);
+    if (!abstracts.empty()) {
+        token.abstract = abstracts[0];
+    }
+    token.parameterTerms = allTextOf("/*/Parameters/Parameter/Term", doc);
+    token.parameterDiscussions = allTextOf("/*/Parameters/Parameter/Discussion", doc);
+    token.fieldDiscussions = allTextOf("/*/Fields/Field/Discussion", doc);
+    xmlFreeDoc(doc);
+    return true;
+}
+
+static bool operator==(const DocToken& left, const DocToken& right)
+{
+    return left.abstract == right.abstract && left.parameterTerms == right.parameterTerms && left.parameterDiscussions == right.parameterDiscussions && left.fieldDiscussions == right.fieldDiscussions;
+}
+
+static string generatedToken(size_t index)
+{
+    string name = "method" + to_string(index);
+    string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Token>\n";
+    xml += "  <TokenIdentifier><Name>" + name + "</Name><APILanguage>occ</APILanguage><Type>instm</Type><Scope>NSView</Scope></TokenIdentifier>\n";
+    xml += "  <Abstract type=\"html\">\n    Returns the <code>NSView</code> &amp; its subviews for <i>" + name + "</i>.\n  </Abstract>\n";
+    xml += "  <DeclaredIn><HeaderPath>AppKit.framework/Headers/NSView.h</HeaderPath><FrameworkName>AppKit</FrameworkName></DeclaredIn>\n";
+    xml += "  <Declaration type=\"html\">&lt;pre&gt;- (void)" + name + ":(NSRect)frameRect;&lt;/pre&gt;</Declaration>\n";
+    xml += "  <Parameters>\n";
+    for (size_t i = 0; i < index % 5; i++) {
+        xml += "    <Parameter>\n      <Term>param" + to_string(i) + "</Term>\n";
+        if (i == 3) {
+            xml += "      <Discussion/>\n";
+        } else {
+            xml += "      <Discussion><p>The <code>param" + to_string(i) + "</code> passed to <![CDATA[" + name + " <raw>]]>, which is\n        described across lines.</p></Discussion>\n";
+        }
+        xml += "    </Parameter>\n";
+    }
+    xml += "  </Parameters>\n";
+    if (index % 3 == 0) {
+        xml += "  <Fields>\n";
+        for (size_t i = 0; i < 4; i++) {
+            xml += "    <Field><Term>field" + to_string(i) + "</Term><Discussion>  Field <b>" + to_string(i) + "</b> of the struct.  </Discussion></Field>\n";
+        }
+        xml += "  </Fields>\n";
+    }
+    xml += "  <ReturnValue><Abstract type=\"html\">Not the abstract of the token.</Abstract></ReturnValue>\n";
+    xml += "  <Availability distribution=\"macOS\"><IntroducedInVersion>10.0</IntroducedInVersion></Availability>\n";
+    xml += "</Token>\n";
+    return xml;
+}
+
+static vector<string> generateTokens(size_t count, llvm::SmallString<128>& directory)
+{
+    vector<string> paths;
+    if (llvm::sys::fs::createUniqueDirectory("doc-tokens", directory)) {
+        return paths;
+    }
+    for (size_t i = 0; i < count; i++) {
+        string path = string(directory.str()) + "/" + to_string(i) + ".xml";
+        error_code error;
+        llvm::raw_fd_ostream file(path, error, llvm::sys::fs::F_Text);
+        if (error) {
+            break;
+        }
+        file << generatedToken(i);
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+static vector<string> findTokens(const string& directory)
+{
+    vector<string> paths;
+    error_code error;
+    for (llvm::sys::fs::recursive_directory_iterator it(directory, error), end; it != end && !error; it.increment(error)) {
+        const string& path = it->path();
+        if (path.size() > 4 && path.compare(path.size() - 4, 4, ".xml") == 0) {
+            paths.push_back(path);
+        }
+    }
+    return paths;
+}
+
+int main(int argc, const char** argv)
+{
+    xmlMemSetup(countingFree, countingMalloc, countingRealloc, countingStrdup);
+    xmlInitParser();
+
+    size_t iterations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 5;
+    llvm::SmallString<128> generatedDirectory;
+    vector<string> paths = argc > 1 ? findTokens(argv[1]) : generateTokens(2000, generatedDirectory);
+    if (paths.empty()) {
+        cerr << "error: no token files to read" << endl;
+        return 1;
+    }
+
+    bool mismatch = false;
+    size_t xpathPeak = 0, readerPeak = 0;
+    for (const string& path : paths) {
+        DocToken expected, actual;
+
+        size_t before = peakBytes = currentBytes;
+        bool expectedRead = readWithXPath(path, expected);
+        xpathPeak = max(xpathPeak, peakBytes - before);
+
+        before = peakBytes = currentBytes;
+        bool actualRead = DocTokenReader::read(path, actual);
+        readerPeak = max(readerPeak, peakBytes - before);
+
+        if (expectedRead != actualRead || !(expected == actual)) {
+            cerr << "error: " << path << " reads differently with the reader" << endl;
+            mismatch = true;
+        }
+    }
+
+    auto ms = [](chrono::steady_clock::duration d) {
+        return chrono::duration_cast<chrono::microseconds>(d).count() / 1000.0;
+    };
+
+    size_t checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        for (const string& path : paths) {
+            DocToken token;
+            readWithXPath(path, token);
+            checksum += token.abstract.size() + token.parameterTerms.size();
+        }
+    }
+    auto xpathDone = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        for (const string& path : paths) {
+            DocToken token;
+            DocTokenReader::read(path, token);
+            checksum -= token.abstract.size() + token.parameterTerms.size();
+        }
+    }
+    auto readerDone = chrono::steady_clock::now();
+
+    double documents = iterations * paths.size();
+    cout << paths.size() << " token files, " << iterations << " iterations" << (checksum ? " (checksums differ)" : "") << endl;
+    cout << "tree + XPath: " << ms(xpathDone - start) * 1000 / documents << " us per document, peak " << xpathPeak << " bytes" << endl;
+    cout << "reader:       " << ms(readerDone - xpathDone) * 1000 / documents << " us per document, peak " << readerPeak << " bytes" << endl;
+
+    if (!generatedDirectory.empty()) {
+        llvm::sys::fs::remove_directories(generatedDirectory);
+    }
+    xmlCleanupParser();
+
+    if (mismatch) {
+        return 1;
+    }
+    cout << "the reader extracts the same text as the XPath queries" << endl;
+    return 0;
+}
@@ -0,0 +1,133 @@
+//
+//  EmissionBufferBenchmark.cpp
+//  MetadataGenerator
+//
+//  Compares TypeScript::EmissionBuffer against the std::ostringstream buffers
+//  the writers used to emit through: a buffer per writer which is copied out
+//  with str() and reset with str("") after every meta, and a temporary stream
+//  for every member. Both build the same text, the heap allocations and the
+//  throughput of both are reported.
+//
+//  Usage: emission-buffer-benchmark [modules] [metas per module] [members per meta]
+//
+
+#include "TypeScript/EmissionBuffer.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+static size_t allocationsCount = 0;
+
+void* operator new(size_t size)
+{
+    allocationsCount++;
+    if (void* pointer = malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+static const string memberName = "initWithFrame";
+static const string typeName = "NSRect";
+
+// A member the way the writers emit one: comments, a declaration built in a temporary stream, its parameters
+template <class Stream>
+static string writeMember(size_t index)
+{
+    Stream output;
+    output << "@objc public func " << memberName << index << "(_ frame: " << typeName << ", options: [String: Any]?)";
+    output << " -> " << typeName << "Exports";
+    return output.str();
+}
+
+template <class Stream>
+static void writeMeta(Stream& buffer, size_t meta, size_t membersCount)
+{
+    buffer << "\n// Interface \n";
+    buffer << "@objc(NSView" << meta << ") protocol NSView" << meta << "Exports: JSExport, NSResponderExports {" << endl;
+    for (size_t i = 0; i < membersCount; i++) {
+        buffer << "\n  /**\n    - Selector: " << memberName << ":\n  */\n";
+        buffer << "  " << writeMember<Stream>(i) << endl;
+    }
+    buffer << "}\n\n";
+}
+
+// Stands in for writing the file of a meta
+static size_t consume(const char* data, size_t size)
+{
+    return size ? size + data[size / 2] : 0;
+}
+
+static size_t writeModulesWithStreams(size_t modules, size_t metas, size_t members)
+{
+    size_t written = 0;
+    for (size_t module = 0; module < modules; module++) {
+        ostringstream buffer;
+        for (size_t meta = 0; meta < metas; meta++) {
+            writeMeta(buffer, meta, members);
+            string text = buffer.str();
+            written += consume(text.data(), text.size());
+            buffer.str("");
+            buffer.clear();
+        }
+    }
+    return written;
+}
+
+static size_t writeModulesWithEmissionBuffers(size_t modules, size_t metas, size_t members)
+{
+    size_t written = 0;
+    for (size_t module = 0; module < modules; module++) {
+        TypeScript::EmissionBuffer buffer;
+        for (size_t meta = 0; meta < metas; meta++) {
+            writeMeta(buffer, meta, members);
+            llvm::StringRef text = buffer.ref();
+            written += consume(text.data(), text.size());
+            buffer.clear();
+        }
+    }
+    return written;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t modules = argc > 1 ? strtoul(argv[1], nullptr, 10) : 50;
+    size_t metas = argc > 2 ? strtoul(argv[2], nullptr, 10) : 200;
+    size_t members = argc > 3 ? strtoul(argv[3], nullptr, 10) : 30;
+
+    auto measure = [&](const char* name, function<size_t()> write) {
+        size_t allocationsBefore = allocationsCount;
+        auto start = chrono::steady_clock::now();
+        size_t written = write();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << name << ": " << allocationsCount - allocationsBefore << " allocations, "
+             << seconds * 1000 << " ms, " << written / seconds / (1 << 20) << " MB/s" << endl;
+        return written;
+    };
+
+    cout << modules << " modules of " << metas << " metas with " << members << " members" << endl;
+    size_t expected = measure("ostringstream ", [&]() { return writeModulesWithStreams(modules, metas, members); });
+    size_t actual = measure("EmissionBuffer", [&]() { return writeModulesWithEmissionBuffers(modules, metas, members); });
+
+    if (expected != actual) {
+        cerr << "error: the buffers wrote different text" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+//
+//  ExportedClassesCheck.cpp
+//  MetadataGenerator
+//
+//  Checks which inherited class methods a subclass leaves to the export
+//  protocol of its superclass in -jsexport-inheritance mode. Subclasses of
+//  classes whose export protocols aren't written, e.g. NSMutableString of
+//  NSString, have to keep declaring their class methods.
+//
+//  Usage: exported-classes-check
+//
+
+#include "JSExport/ExportedClasses.h"
+#include <iostream>
+
+using namespace std;
+using namespace TypeScript;
+
+int main()
+{
+    struct Case {
+        const char* description;
+        bool ownerIsInterface;
+        const char* ownerName;
+        const char* ownerJsName;
+        bool returnsInstance;
+        bool declaredByOwner;
+    };
+
+    const Case cases[] = {
+        { "NSMutableString +localizedNameOfStringEncoding: of NSString", true, "NSString", "NSString", false, false },
+        { "NSMutableString +availableStringEncodings of NSString", true, "NSString", "NSString", false, false },
+        { "NSMutableData +dataWithContentsOfURL: of NSData", true, "NSData", "NSData", false, false },
+        { "NSView +defaultMenu of NSResponder", true, "NSResponder", "NSResponder", false, false },
+        { "NSURLSessionDataTask class methods of NSURLSessionTask", true, "NSURLSessionTask", "URLSessionTask", false, false },
+        { "a subclass of a class starting with _", true, "_NSPrivate", "_NSPrivate", false, false },
+        { "NSMutableArray +arrayWithArray: of NSArray", true, "NSArray", "NSArray", false, true },
+        { "NSMutableArray +array of NSArray, returning instancetype", true, "NSArray", "NSArray", true, false },
+        { "NSMutableString +readableTypesForPasteboard: of NSPasteboardReading", false, "NSPasteboardReading", "NSPasteboardReading", false, false },
+    };
+
+    bool failed = false;
+    for (const Case& check : cases) {
+        bool declaredByOwner = ExportedClasses::declaredByOwnerExports(check.ownerIsInterface, check.ownerName, check.ownerJsName, check.returnsInstance);
+        if (declaredByOwner != check.declaredByOwner) {
+            cerr << "error: " << check.description << (check.declaredByOwner ? " is" : " isn't") << " declared by the export protocol of "
+                 << check.ownerName << endl;
+            failed = true;
+        }
+    }
+
+    if (!ExportedClasses::writesExports("NSArray", "NSArray") || ExportedClasses::writesExports("NSString", "NSString")) {
+        cerr << "error: the export protocols of NSArray and NSString" << endl;
+        failed = true;
+    }
+
+    if (!failed) {
+        cout << "The export protocols of " << sizeof(cases) / sizeof(cases[0]) << " owners of inherited class methods are as expected." << endl;
+    }
+    return failed ? 1 : 0;
+}
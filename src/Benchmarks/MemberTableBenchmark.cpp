@@ -0,0 +1,144 @@
+//
+//  MemberTableBenchmark.cpp
+//  MetadataGenerator
+//
+//  Compares TypeScript::MemberTable passed by const reference against the
+//  std::map<std::string, ...> member maps the writers used to copy for every
+//  property they wrote. Counts the heap allocations of both on a generated
+//  class hierarchy shaped like AppKit's views.
+//
+//  Usage: member-table-benchmark [classes] [members per class] [depth]
+//
+
+#include "TypeScript/MemberTable.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+
+using namespace std;
+
+static size_t allocationsCount = 0;
+
+void* operator new(size_t size)
+{
+    allocationsCount++;
+    if (void* pointer = malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+struct Class;
+
+struct Property {
+    string name;
+    size_t typeId;
+};
+
+struct Class {
+    Class* base;
+    vector<Property*> properties;
+};
+
+typedef map<string, pair<Class*, Property*> > PropertyMap;
+typedef TypeScript::MemberTable<Class, Property> PropertyTable;
+
+// What writeProperty did with the properties of the base class, the result only keeps the work from being optimized out
+static size_t writePropertyByValue(Property* property, PropertyMap baseClassProperties)
+{
+    auto result = baseClassProperties.find(property->name);
+    return result != baseClassProperties.end() && result->second.second->typeId != property->typeId;
+}
+
+static size_t writePropertyByReference(Property* property, const PropertyTable& baseClassProperties)
+{
+    auto result = baseClassProperties.find(property->name);
+    return result != baseClassProperties.end() && result->second.second->typeId != property->typeId;
+}
+
+template <class Table>
+static size_t writeClasses(const vector<Class*>& classes, size_t (*writeProperty)(Property*, Table))
+{
+    typedef typename remove_const<typename remove_reference<Table>::type>::type Members;
+    size_t optedOut = 0;
+    for (Class* klass : classes) {
+        Members ownProperties;
+        for (Property* property : klass->properties) {
+            ownProperties.emplace(property->name, make_pair(klass, property));
+        }
+        Members baseClassProperties;
+        for (Class* base = klass->base; base; base = base->base) {
+            for (Property* property : base->properties) {
+                baseClassProperties.emplace(property->name, make_pair(base, property));
+            }
+        }
+        for (auto& propertyPair : ownProperties) {
+            optedOut += writeProperty(propertyPair.second.second, baseClassProperties);
+        }
+    }
+    return optedOut;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t classesCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : 2000;
+    size_t membersPerClass = argc > 2 ? strtoul(argv[2], nullptr, 10) : 30;
+    size_t depth = argc > 3 ? strtoul(argv[3], nullptr, 10) : 6;
+
+    mt19937 random(42);
+    vector<string> names;
+    for (size_t i = 0; i < membersPerClass * 4; i++) {
+        names.push_back("property" + to_string(random() % 100000) + "WithSomeLongerName");
+    }
+
+    vector<Class*> classes;
+    for (size_t i = 0; i < classesCount; i++) {
+        Class* klass = new Class();
+        // Every class derives from one of the last few classes, so the chains are about `depth` deep
+        klass->base = i % depth == 0 ? nullptr : classes.back();
+        for (size_t m = 0; m < membersPerClass; m++) {
+            klass->properties.push_back(new Property({ names[random() % names.size()], random() % 8 }));
+        }
+        classes.push_back(klass);
+    }
+
+    auto ms = [](chrono::steady_clock::duration d) {
+        return chrono::duration_cast<chrono::microseconds>(d).count() / 1000.0;
+    };
+
+    size_t allocationsBefore = allocationsCount;
+    auto start = chrono::steady_clock::now();
+    size_t mapResult = writeClasses<PropertyMap>(classes, writePropertyByValue);
+    auto mapDone = chrono::steady_clock::now();
+    size_t mapAllocations = allocationsCount - allocationsBefore;
+
+    allocationsBefore = allocationsCount;
+    size_t tableResult = writeClasses<const PropertyTable&>(classes, writePropertyByReference);
+    auto tableDone = chrono::steady_clock::now();
+    size_t tableAllocations = allocationsCount - allocationsBefore;
+
+    cout << classes.size() << " classes, " << membersPerClass << " properties each, inheritance depth " << depth << endl;
+    cout << "map by value:       " << ms(mapDone - start) << " ms, " << mapAllocations << " allocations" << endl;
+    cout << "table by reference: " << ms(tableDone - mapDone) << " ms, " << tableAllocations << " allocations" << endl;
+
+    if (mapResult != tableResult) {
+        cerr << "error: the map and the table found different properties" << endl;
+        return 1;
+    }
+    cout << "results match (" << mapResult << " properties opted out of type checking)" << endl;
+    return 0;
+}
@@ -0,0 +1,136 @@
+//
+//  ModulesBlocklistBenchmark.cpp
+//  MetadataGenerator
+//
+//  Compares Meta::ModulesBlocklist against the linear scan with the recursive
+//  wildcard matcher it replaced, using a few thousand generated patterns.
+//
+//  Usage: modules-blocklist-benchmark [patterns] [modules] [symbols per module]
+//
+
+#include "Meta/Filters/ModulesBlocklist.h"
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+using namespace std;
+typedef Meta::ModulesBlocklist::ModuleAndSymbolNamePatternsList PatternsList;
+
+// The previous implementation, kept here as the baseline. The only change is that
+// '?' no longer matches (and steps over) the terminating NUL of the string.
+static bool recursiveMatch(const char* pattern, const char* string)
+{
+    if (*pattern == '\0' && *string == '\0')
+        return true;
+    if (pattern[0] == '*' && pattern[1] == '\0')
+        return true;
+    if (*pattern == '*' && *(pattern+1) != '\0' && *string == '\0')
+        return false;
+    if (*pattern == '?' || *pattern == *string)
+        return *string != '\0' && recursiveMatch(pattern+1, string+1);
+    if (*pattern == '*')
+        return recursiveMatch(pattern+1, string) || recursiveMatch(pattern, string+1);
+    return false;
+}
+
+static bool linearShouldBlocklist(const PatternsList& whitelist, const PatternsList& blocklist, const string& moduleName, const string& symbolName)
+{
+    auto findMatchingPattern = [&moduleName, &symbolName](const PatternsList& v) {
+        return find_if(v.begin(), v.end(), [&moduleName, &symbolName](const Meta::ModulesBlocklist::ModuleAndSymbolNamePatterns& item) {
+            return (item.modulePattern.empty() || recursiveMatch(item.modulePattern.c_str(), moduleName.c_str()))
+                && (item.symbolPattern.empty() || recursiveMatch(item.symbolPattern.c_str(), symbolName.c_str()));
+        });
+    };
+    bool enabledByWhitelist = findMatchingPattern(whitelist) != whitelist.end();
+    bool disabledByBlocklist = findMatchingPattern(blocklist) != blocklist.end();
+    return disabledByBlocklist || !enabledByWhitelist;
+}
+
+static string randomName(mt19937& random, const char* prefix, size_t length)
+{
+    static const char letters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    string name(prefix);
+    for (size_t i = 0; i < length; i++) {
+        name += letters[random() % (sizeof(letters) - 1)];
+    }
+    return name;
+}
+
+// Mixes exact names, prefix globs and patterns with several wildcards
+static string randomPattern(mt19937& random, const vector<string>& names)
+{
+    string name = names[random() % names.size()];
+    switch (random() % 4) {
+    case 0:
+        return name;
+    case 1:
+        return name.substr(0, name.size() / 2) + "*";
+    case 2:
+        return "*" + name.substr(name.size() / 2) + "*";
+    default:
+        return name.substr(0, 2) + "*" + name.substr(3, 2) + "*?" + name.substr(name.size() - 1) + "*";
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    size_t patternsCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : 5000;
+    size_t modulesCount = argc > 2 ? strtoul(argv[2], nullptr, 10) : 200;
+    size_t symbolsPerModule = argc > 3 ? strtoul(argv[3], nullptr, 10) : 100;
+
+    mt19937 random(42);
+    vector<string> modules;
+    for (size_t i = 0; i < modulesCount; i++) {
+        modules.push_back(randomName(random, "Kit", 8) + (i % 3 == 0 ? "." + randomName(random, "", 6) : ""));
+    }
+    vector<string> symbols;
+    for (size_t i = 0; i < symbolsPerModule; i++) {
+        symbols.push_back(randomName(random, "NS", 12));
+    }
+
+    PatternsList whitelist, blocklist;
+    for (size_t i = 0; i < patternsCount; i++) {
+        PatternsList& list = i % 2 == 0 ? whitelist : blocklist;
+        string symbolPattern = random() % 3 == 0 ? string() : randomPattern(random, symbols);
+        list.push_back({ randomPattern(random, modules), symbolPattern });
+    }
+
+    auto start = chrono::steady_clock::now();
+    Meta::ModulesBlocklist modulesBlocklist(whitelist, blocklist, /*whitelistDefined*/ true);
+    auto compiled = chrono::steady_clock::now();
+
+    vector<bool> compiledVerdicts;
+    compiledVerdicts.reserve(modules.size() * symbols.size());
+    string enabledBy, disabledBy;
+    for (const string& module : modules) {
+        for (const string& symbol : symbols) {
+            compiledVerdicts.push_back(modulesBlocklist.shouldBlocklist(module, symbol, enabledBy, disabledBy));
+        }
+    }
+    auto compiledDone = chrono::steady_clock::now();
+
+    vector<bool> linearVerdicts;
+    linearVerdicts.reserve(modules.size() * symbols.size());
+    for (const string& module : modules) {
+        for (const string& symbol : symbols) {
+            linearVerdicts.push_back(linearShouldBlocklist(whitelist, blocklist, module, symbol));
+        }
+    }
+    auto linearDone = chrono::steady_clock::now();
+
+    auto ms = [](chrono::steady_clock::duration d) {
+        return chrono::duration_cast<chrono::microseconds>(d).count() / 1000.0;
+    };
+
+    size_t checks = modules.size() * symbols.size();
+    cout << patternsCount << " patterns, " << checks << " symbol checks over " << modules.size() << " modules" << endl;
+    cout << "compiled: " << ms(compiled - start) << " ms to compile, " << ms(compiledDone - compiled) << " ms to check" << endl;
+    cout << "linear:   " << ms(linearDone - compiledDone) << " ms to check" << endl;
+
+    if (compiledVerdicts != linearVerdicts) {
+        cerr << "error: compiled and linear verdicts differ" << endl;
+        return 1;
+    }
+    cout << "verdicts match (" << count(compiledVerdicts.begin(), compiledVerdicts.end(), true) << " blocklisted)" << endl;
+    return 0;
+}
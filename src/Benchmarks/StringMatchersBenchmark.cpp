@@ -0,0 +1,159 @@
+//
+//  StringMatchersBenchmark.cpp
+//  MetadataGenerator
+//
+//  Compares the matchers of Utils/StringMatchers.h against the std::regex
+//  patterns they replaced, built per call as the writers used to. Every
+//  matcher is run on the same type names and selectors and has to give the
+//  same result as its regex.
+//
+//  Usage: string-matchers-benchmark [iterations]
+//
+
+#include "Utils/StringMatchers.h"
+#include "Utils/StringUtils.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <regex>
+#include <vector>
+
+using namespace std;
+
+static const vector<string> samples = {
+    "NSObject<NSCopying>", "NSObject<NSCopying, NSSecureCoding>", "NSObject", "NSArray<id>",
+    "NSArray<NSString *> * _Nullable", "NSDictionary<NSString *,id>", "NSDictionary<NSString,id>",
+    "NSSet<NSString>", "Set<String>", "NSSet<NSString *>", "Set<>", "Set<Foo>Set<Bar>", "NSMutableSet<NSView>",
+    "NSError * _Nullable * _Nullable", "id  _Nullable * _Nullable", "const void *", "CGPointPointer", "Pointer",
+    "UnsafeMutablePointer<Int>", "NSURL", "NSView", "AVPlayer", "IKImageView", "NS", "N",
+    "NSString * _Nullable", "void (^ _Nullable)(NSError * _Nullable)", "BOOL (^)(id _Nonnull)",
+    "func foo(_ p0: JSValue) -> Bool", "func foo() -> JSValue\n  // more", "JSValue", "",
+    "initWithFrame", "initWithContentsOfURL:", "init:frame:", "init", "Swift.String", "Swift.",
+    "nextEvent(matching:until:inMode:dequeue:)", "fileurl", "url", "xid", "id", "compareWithTests",
+    "WithTests", "compareWithTest", "loadWithCompletionHandler", "CompletionHandler", "text-view", "scroll-view",
+    "createWithFrameWithOptions", "With"
+};
+
+struct Case {
+    string name;
+    function<string(const string&)> regexVersion;
+    function<string(const string&)> matcherVersion;
+};
+
+static string boolString(bool value)
+{
+    return value ? "true" : "false";
+}
+
+int main(int argc, const char** argv)
+{
+    size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200;
+
+    vector<Case> cases = {
+        { "^NSObject<(\\w+)>$",
+            [](const string& s) { return regex_replace(s, regex("^NSObject<(\\w+)>$"), "$1"); },
+            [](const string& s) { string argument = StringMatchers::genericArgument(s, "NSObject"); return argument.empty() ? s : argument; } },
+        { "^\\w+<(\\w+)>$",
+            [](const string& s) { return regex_replace(s, regex("^\\w+<(\\w+)>$"), "$1"); },
+            [](const string& s) { string argument = StringMatchers::genericArgument(s); return argument.empty() ? s : argument; } },
+        { "^\\w+<\\w+,id>$",
+            [](const string& s) { return boolString(regex_match(s, regex("^\\w+<\\w+,id>$"))); },
+            [](const string& s) { return boolString(StringMatchers::isGenericWithIdValue(s)); } },
+        { ".*JSValue.*",
+            [](const string& s) { return boolString(regex_match(s, regex(".*JSValue.*"))); },
+            [](const string& s) { return boolString(StringMatchers::lineContains(s, "JSValue")); } },
+        { ".* _Nullable.*",
+            [](const string& s) { return boolString(regex_match(s, regex(".* _Nullable.*"))); },
+            [](const string& s) { return boolString(StringMatchers::lineContains(s, " _Nullable")); } },
+        { ".* _Nullable$",
+            [](const string& s) { return boolString(regex_match(s, regex(".* _Nullable$"))); },
+            [](const string& s) { return boolString(StringMatchers::lineEndsWith(s, " _Nullable")); } },
+        { ".*Pointer$",
+            [](const string& s) { return boolString(regex_match(s, regex(".*Pointer$"))); },
+            [](const string& s) { return boolString(StringMatchers::lineEndsWith(s, "Pointer")); } },
+        { "UnsafeMutablePointer",
+            [](const string& s) { return regex_replace(s, regex("UnsafeMutablePointer"), "AutoreleasingUnsafeMutablePointer"); },
+            [](const string& s) { return StringUtils::replaceString(s, "UnsafeMutablePointer", "AutoreleasingUnsafeMutablePointer"); } },
+        { "NSArray<id>",
+            [](const string& s) { return regex_replace(s, regex("NSArray<id>"), "[Object]"); },
+            [](const string& s) { return StringUtils::replaceString(s, "NSArray<id>", "[Object]"); } },
+        { "Set<\\w+>",
+            [](const string& s) { return regex_replace(s, regex("Set<\\w+>"), "Set"); },
+            [](const string& s) { return StringMatchers::replaceGenerics(s, "Set", "Set"); } },
+        { "^(NS|AV|IK)",
+            [](const string& s) { return regex_replace(s, regex("^(NS|AV|IK)"), ""); },
+            [](const string& s) { return StringMatchers::removeFrameworkPrefix(s); } },
+        { "^initWith",
+            [](const string& s) { return regex_replace(s, regex("^initWith"), "createWith"); },
+            [](const string& s) { return StringMatchers::replacePrefix(s, "initWith", "createWith"); } },
+        { "^Swift\\.",
+            [](const string& s) { return regex_replace(s, regex("^Swift\\."), ""); },
+            [](const string& s) { return StringMatchers::replacePrefix(s, "Swift.", ""); } },
+        { "\\( and \\)",
+            [](const string& s) { return regex_replace(regex_replace(s, regex("\\("), ":"), regex("\\)"), ""); },
+            [](const string& s) { return StringUtils::replaceString(StringUtils::replaceString(s, "(", ":"), ")", ""); } },
+        { "CompletionHandler$",
+            [](const string& s) { return regex_replace(s, regex("CompletionHandler$"), "Callback"); },
+            [](const string& s) { return StringMatchers::replaceSuffix(s, "CompletionHandler", "Callback"); } },
+        { "-view$",
+            [](const string& s) { return regex_replace(s, regex("-view$"), ""); },
+            [](const string& s) { return StringMatchers::replaceSuffix(s, "-view", ""); } },
+        { "With",
+            [](const string& s) { return regex_replace(s, regex("With"), "_"); },
+            [](const string& s) { return StringUtils::replaceString(s, "With", "_"); } },
+        { "(\\w+)url$",
+            [](const string& s) { return regex_replace(s, regex("(\\w+)url$"), "$1URL"); },
+            [](const string& s) { return StringMatchers::replaceWordSuffix(s, "url", "URL"); } },
+        { "(\\w+)id$",
+            [](const string& s) { return regex_replace(s, regex("(\\w+)id$"), "$1ID"); },
+            [](const string& s) { return StringMatchers::replaceWordSuffix(s, "id", "ID"); } },
+        { "(\\w+)WithTests?$",
+            [](const string& s) { return regex_replace(regex_replace(s, regex("(\\w+)WithTests$"), "$1With"), regex("(\\w+)WithTest$"), "$1With"); },
+            [](const string& s) { return StringMatchers::replaceWordSuffix(StringMatchers::replaceWordSuffix(s, "WithTests", "With"), "WithTest", "With"); } },
+    };
+
+    auto ms = [](chrono::steady_clock::duration d) {
+        return chrono::duration_cast<chrono::microseconds>(d).count() / 1000.0;
+    };
+
+    bool mismatch = false;
+    double regexTotal = 0, matcherTotal = 0;
+    for (const Case& benchmarkCase : cases) {
+        for (const string& sample : samples) {
+            string expected = benchmarkCase.regexVersion(sample);
+            string actual = benchmarkCase.matcherVersion(sample);
+            if (expected != actual) {
+                cerr << "error: " << benchmarkCase.name << " on \"" << sample << "\": regex gives \"" << expected << "\", matcher gives \"" << actual << "\"" << endl;
+                mismatch = true;
+            }
+        }
+
+        size_t checksum = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            for (const string& sample : samples) {
+                checksum += benchmarkCase.regexVersion(sample).size();
+            }
+        }
+        auto regexDone = chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            for (const string& sample : samples) {
+                checksum -= benchmarkCase.matcherVersion(sample).size();
+            }
+        }
+        auto matcherDone = chrono::steady_clock::now();
+
+        regexTotal += ms(regexDone - start);
+        matcherTotal += ms(matcherDone - regexDone);
+        cout << benchmarkCase.name << ": regex " << ms(regexDone - start) << " ms, matcher " << ms(matcherDone - regexDone) << " ms" << (checksum ? " (checksums differ)" : "") << endl;
+    }
+
+    cout << "total over " << iterations * samples.size() << " strings per pattern: regex " << regexTotal << " ms, matchers " << matcherTotal << " ms" << endl;
+
+    if (mismatch) {
+        return 1;
+    }
+    cout << "all matchers agree with their regex" << endl;
+    return 0;
+}
@@ -0,0 +1,271 @@
+//
+//  TypeVisitorBenchmark.cpp
+//  MetadataGenerator
+//
+//  Compares visiting types with Type::dispatch against the virtual calls of
+//  Type::visit, on a generated corpus shaped like the parameters of SDK
+//  methods: mostly primitives, with pointers, arrays, blocks and generic type
+//  arguments. Times a visitor which counts the types either way, and
+//  NameRetrieverVisitor against the visitor returning std::strings it
+//  replaces, whose names both have to be the same.
+//
+//  Usage: type-visitor-benchmark [types] [iterations]
+//
+
+#include "Meta/NameRetrieverVisitor.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+static size_t allocationsCount = 0;
+
+void* operator new(size_t size)
+{
+    allocationsCount++;
+    if (void* pointer = malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+// The TypeScript names of the previous NameRetrieverVisitor, with the element names of fixed arrays kept.
+// The types of the corpus have no metas.
+class StringNameVisitor : public TypeVisitor<string> {
+public:
+    string visitVoid() override { return "void"; }
+    string visitBool() override { return "boolean"; }
+    string visitShort() override { return "number"; }
+    string visitUShort() override { return "number"; }
+    string visitInt() override { return "number"; }
+    string visitUInt() override { return "number"; }
+    string visitLong() override { return "number"; }
+    string visitUlong() override { return "number"; }
+    string visitLongLong() override { return "number"; }
+    string visitULongLong() override { return "number"; }
+    string visitSignedChar() override { return "number"; }
+    string visitUnsignedChar() override { return "number"; }
+    string visitUnichar() override { return "number"; }
+    string visitCString() override { return "string"; }
+    string visitFloat() override { return "number"; }
+    string visitDouble() override { return "number"; }
+    string visitVaList() override { return ""; }
+    string visitSelector() override { return "string"; }
+    string visitInstancetype() override { return "any"; }
+    string visitClass(const ClassType&) override { return "any"; }
+    string visitProtocol() override { return "any"; }
+    string visitId(const IdType&) override { return "any"; }
+    string visitConstantArray(const ConstantArrayType& type) override { return type.innerType->visit(*this).append("[]"); }
+    string visitExtVector(const ExtVectorType& type) override { return type.innerType->visit(*this).append("[]"); }
+    string visitIncompleteArray(const IncompleteArrayType& type) override { return type.innerType->visit(*this).append("[]"); }
+    string visitInterface(const InterfaceType&) override { return ""; }
+    string visitBridgedInterface(const BridgedInterfaceType& type) override { return type.name; }
+    string visitPointer(const PointerType&) override { return "any"; }
+    string visitBlock(const BlockType& type) override { return functionName(type.signature); }
+    string visitFunctionPointer(const FunctionPointerType& type) override { return functionName(type.signature); }
+    string visitStruct(const StructType&) override { return ""; }
+    string visitUnion(const UnionType&) override { return ""; }
+    string visitAnonymousStruct(const AnonymousStructType&) override { return ""; }
+    string visitAnonymousUnion(const AnonymousUnionType&) override { return ""; }
+    string visitEnum(const EnumType&) override { return ""; }
+    string visitTypeArgument(const TypeArgumentType& type) override { return type.name; }
+
+private:
+    string functionName(const vector<Type*>& signature)
+    {
+        stringstream ss;
+        ss << "(";
+        for (size_t i = 1; i < signature.size(); i++) {
+            if (i > 1) {
+                ss << ", ";
+            }
+            ss << "p" << i << ": " << signature[i]->visit(*this);
+        }
+        ss << ") => " << signature[0]->visit(*this);
+        return ss.str();
+    }
+};
+
+// Counts a type and the ones it is made of, through the vtable when visited as a TypeVisitor
+template <class Base>
+class CountingVisitor : public Base {
+public:
+    size_t visitVoid() { return 1; }
+    size_t visitBool() { return 1; }
+    size_t visitShort() { return 1; }
+    size_t visitUShort() { return 1; }
+    size_t visitInt() { return 1; }
+    size_t visitUInt() { return 1; }
+    size_t visitLong() { return 1; }
+    size_t visitUlong() { return 1; }
+    size_t visitLongLong() { return 1; }
+    size_t visitULongLong() { return 1; }
+    size_t visitSignedChar() { return 1; }
+    size_t visitUnsignedChar() { return 1; }
+    size_t visitUnichar() { return 1; }
+    size_t visitCString() { return 1; }
+    size_t visitFloat() { return 1; }
+    size_t visitDouble() { return 1; }
+    size_t visitVaList() { return 1; }
+    size_t visitSelector() { return 1; }
+    size_t visitInstancetype() { return 1; }
+    size_t visitClass(const ClassType&) { return 1; }
+    size_t visitProtocol() { return 1; }
+    size_t visitId(const IdType&) { return 1; }
+    size_t visitConstantArray(const ConstantArrayType& type) { return 1 + type.innerType->dispatch(*this); }
+    size_t visitExtVector(const ExtVectorType& type) { return 1 + type.innerType->dispatch(*this); }
+    size_t visitIncompleteArray(const IncompleteArrayType& type) { return 1 + type.innerType->dispatch(*this); }
+    size_t visitInterface(const InterfaceType&) { return 1; }
+    size_t visitBridgedInterface(const BridgedInterfaceType&) { return 1; }
+    size_t visitPointer(const PointerType& type) { return 1 + type.innerType->dispatch(*this); }
+    size_t visitBlock(const BlockType& type) { return 1 + countAll(type.signature); }
+    size_t visitFunctionPointer(const FunctionPointerType& type) { return 1 + countAll(type.signature); }
+    size_t visitStruct(const StructType&) { return 1; }
+    size_t visitUnion(const UnionType&) { return 1; }
+    size_t visitAnonymousStruct(const AnonymousStructType&) { return 1; }
+    size_t visitAnonymousUnion(const AnonymousUnionType&) { return 1; }
+    size_t visitEnum(const EnumType&) { return 1; }
+    size_t visitTypeArgument(const TypeArgumentType&) { return 1; }
+
+private:
+    size_t countAll(const vector<Type*>& types)
+    {
+        size_t count = 0;
+        for (Type* type : types) {
+            count += type->dispatch(*this);
+        }
+        return count;
+    }
+};
+
+struct NoBase {
+};
+
+// Overrides the pure virtual methods of TypeVisitor<size_t> with the ones of CountingVisitor
+class VirtualCountingVisitor final : public CountingVisitor<TypeVisitor<size_t> > {
+};
+
+// Like TypeFactory, the types are owned by shared_ptrs which delete them as the class they were created as
+static void generateTypes(size_t count, vector<shared_ptr<Type> >& storage, vector<Type*>& corpus)
+{
+    auto keep = [&storage](auto* type) {
+        storage.push_back(shared_ptr<typename remove_pointer<decltype(type)>::type>(type));
+        return type;
+    };
+    vector<Type*> primitives = {
+        keep(new Type(TypeType::TypeInt)), keep(new Type(TypeType::TypeBool)), keep(new Type(TypeType::TypeDouble)),
+        keep(new Type(TypeType::TypeULong)), keep(new Type(TypeType::TypeSelector)), keep(new Type(TypeType::TypeVoid)),
+        keep(new IdType()), keep(new Type(TypeType::TypeCString)), keep(new Type(TypeType::TypeInstancetype))
+    };
+    for (size_t i = 0; i < count; i++) {
+        Type* primitive = primitives[i % primitives.size()];
+        switch (i % 10) {
+        case 0:
+            corpus.push_back(keep(new PointerType(primitive)));
+            break;
+        case 1:
+            corpus.push_back(keep(new ConstantArrayType(primitive, 4)));
+            break;
+        case 2:
+            corpus.push_back(keep(new BlockType({ primitives[5], primitive, keep(new PointerType(primitives[6])) })));
+            break;
+        case 3:
+            corpus.push_back(keep(new TypeArgumentType(primitives[6], "ObjectType")));
+            break;
+        case 4:
+            corpus.push_back(keep(new BridgedInterfaceType("NSString", nullptr)));
+            break;
+        default:
+            corpus.push_back(primitive);
+        }
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    size_t typesCount = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    size_t iterations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 20;
+
+    vector<shared_ptr<Type> > storage;
+    vector<Type*> corpus;
+    generateTypes(typesCount, storage, corpus);
+
+    auto measure = [&](const char* name, function<size_t()> visitAll) {
+        size_t allocationsBefore = allocationsCount;
+        auto start = chrono::steady_clock::now();
+        size_t result = 0;
+        for (size_t i = 0; i < iterations; i++) {
+            result += visitAll();
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << name << ": " << (allocationsCount - allocationsBefore) / iterations << " allocations, "
+             << seconds * 1e9 / (iterations * corpus.size()) << " ns per type" << endl;
+        return result;
+    };
+
+    cout << corpus.size() << " types, " << iterations << " iterations" << endl;
+
+    VirtualCountingVisitor virtualCounter;
+    CountingVisitor<NoBase> counter;
+    size_t virtualCount = measure("count, visit     ", [&]() {
+        size_t count = 0;
+        for (Type* type : corpus) {
+            count += type->visit(static_cast<TypeVisitor<size_t>&>(virtualCounter));
+        }
+        return count;
+    });
+    size_t count = measure("count, dispatch  ", [&]() {
+        size_t count = 0;
+        for (Type* type : corpus) {
+            count += type->dispatch(counter);
+        }
+        return count;
+    });
+
+    StringNameVisitor stringNames;
+    size_t stringNamesLength = measure("names, std::string", [&]() {
+        size_t length = 0;
+        for (Type* type : corpus) {
+            length += type->visit(stringNames).size();
+        }
+        return length;
+    });
+    size_t namesLength = measure("names, StringRef  ", [&]() {
+        size_t length = 0;
+        for (Type* type : corpus) {
+            length += type->dispatch(NameRetrieverVisitor::instanceTs).size();
+        }
+        return length;
+    });
+
+    bool mismatch = virtualCount != count || stringNamesLength != namesLength;
+    for (Type* type : corpus) {
+        if (type->visit(stringNames) != type->dispatch(NameRetrieverVisitor::instanceTs)) {
+            mismatch = true;
+            break;
+        }
+    }
+    if (mismatch) {
+        cerr << "error: the visitors disagree" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "binarySerializer.h"
+#include "Meta/JsNameOrder.h"
 #include "Meta/Utils.h"
 #include "binarySerializerPrivate.h"
 #include <clang/Basic/FileManager.h>
@@ -78,7 +79,7 @@ void binary::BinarySerializer::serializeBaseClass(::Meta::BaseClassMeta* meta, b
     vector<MetaFileOffset> offsets;
 
     // instance methods
-    sort(meta->instanceMethods.begin(), meta->instanceMethods.end(), compareMetasByJsName< ::Meta::MethodMeta>);
+    ::Meta::sortByJsName(meta->instanceMethods);
     for (::Meta::MethodMeta* methodMeta : meta->instanceMethods) {
         binary::MethodMeta binaryMeta;
         this->serializeMethod(methodMeta, binaryMeta);
@@ -88,7 +89,7 @@ void binary::BinarySerializer::serializeBaseClass(::Meta::BaseClassMeta* meta, b
     offsets.clear();
 
     // static methods
-    sort(meta->staticMethods.begin(), meta->staticMethods.end(), compareMetasByJsName< ::Meta::MethodMeta>);
+    ::Meta::sortByJsName(meta->staticMethods);
     for (::Meta::MethodMeta* methodMeta : meta->staticMethods) {
         binary::MethodMeta binaryMeta;
         this->serializeMethod(methodMeta, binaryMeta);
@@ -98,7 +99,7 @@ void binary::BinarySerializer::serializeBaseClass(::Meta::BaseClassMeta* meta, b
     offsets.clear();
 
     // instance properties
-    sort(meta->instanceProperties.begin(), meta->instanceProperties.end(), compareMetasByJsName< ::Meta::PropertyMeta>);
+    ::Meta::sortByJsName(meta->instanceProperties);
     for (::Meta::PropertyMeta* propertyMeta : meta->instanceProperties) {
         binary::PropertyMeta binaryMeta;
         this->serializeProperty(propertyMeta, binaryMeta);
@@ -108,7 +109,7 @@ void binary::BinarySerializer::serializeBaseClass(::Meta::BaseClassMeta* meta, b
     offsets.clear();
 
     // static properties
-    sort(meta->staticProperties.begin(), meta->staticProperties.end(), compareMetasByJsName< ::Meta::PropertyMeta>);
+    ::Meta::sortByJsName(meta->staticProperties);
     for (::Meta::PropertyMeta* propertyMeta : meta->staticProperties) {
         binary::PropertyMeta binaryMeta;
         this->serializeProperty(propertyMeta, binaryMeta);
@@ -118,7 +119,7 @@ void binary::BinarySerializer::serializeBaseClass(::Meta::BaseClassMeta* meta, b
     offsets.clear();
 
     // protocols
-    sort(meta->protocols.begin(), meta->protocols.end(), compareMetasByJsName< ::Meta::ProtocolMeta>);
+    ::Meta::sortByJsName(meta->protocols);
     for (::Meta::ProtocolMeta* protocol : meta->protocols) {
         offsets.push_back(this->heapWriter.push_string(protocol->jsName));
     }
@@ -6,7 +6,7 @@ binary::MetaFileOffset binary::BinaryTypeEncodingSerializer::visit(vector< ::Met
 {
     vector<unique_ptr<binary::TypeEncoding> > binaryEncodings;
     for (::Meta::Type* type : types) {
-        unique_ptr<binary::TypeEncoding> binaryEncoding = type->visit(*this);
+        unique_ptr<binary::TypeEncoding> binaryEncoding = type->dispatch(*this);
         binaryEncodings.push_back(move(binaryEncoding));
     }
 
@@ -138,14 +138,14 @@ unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitCons
 {
     binary::ConstantArrayEncoding* s = new binary::ConstantArrayEncoding();
     s->_size = type.size;
-    s->_elementType = type.innerType->visit(*this);
+    s->_elementType = type.innerType->dispatch(*this);
     return unique_ptr<binary::TypeEncoding>(s);
 }
 
 unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitIncompleteArray(const ::Meta::IncompleteArrayType& type)
 {
     binary::IncompleteArrayEncoding* s = new binary::IncompleteArrayEncoding();
-    s->_elementType = type.innerType->visit(*this);
+    s->_elementType = type.innerType->dispatch(*this);
     return unique_ptr<binary::TypeEncoding>(s);
 }
 
@@ -183,7 +183,7 @@ unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitBrid
 unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitPointer(const ::Meta::PointerType& type)
 {
     binary::PointerEncoding* s = new binary::PointerEncoding();
-    s->_target = type.innerType->visit(*this);
+    s->_target = type.innerType->dispatch(*this);
     return unique_ptr<binary::TypeEncoding>(s);
 }
 
@@ -192,7 +192,7 @@ unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitBloc
     binary::BlockEncoding* s = new binary::BlockEncoding();
     s->_encodingsCount = (uint8_t)type.signature.size();
     for (::Meta::Type* signatureType : type.signature) {
-        s->_encodings.push_back(signatureType->visit(*this));
+        s->_encodings.push_back(signatureType->dispatch(*this));
     }
     return unique_ptr<binary::TypeEncoding>(s);
 }
@@ -202,7 +202,7 @@ unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitFunc
     binary::FunctionEncoding* s = new binary::FunctionEncoding();
     s->_encodingsCount = (uint8_t)type.signature.size();
     for (::Meta::Type* signatureType : type.signature) {
-        s->_encodings.push_back(signatureType->visit(*this));
+        s->_encodings.push_back(signatureType->dispatch(*this));
     }
     return unique_ptr<binary::TypeEncoding>(s);
 }
@@ -233,12 +233,12 @@ unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitAnon
 
 unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitEnum(const ::Meta::EnumType& type)
 {
-    return type.underlyingType->visit(*this);
+    return type.underlyingType->dispatch(*this);
 }
 
 unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitTypeArgument(const ::Meta::TypeArgumentType& type)
 {
-    return type.underlyingType->visit(*this);
+    return type.underlyingType->dispatch(*this);
 }
 
 unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::serializeRecordEncoding(const binary::BinaryTypeEncodingType encodingType, const vector< ::Meta::RecordField>& fields)
@@ -251,7 +251,7 @@ unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::serialize
     }
 
     for (const ::Meta::RecordField& field : fields) {
-        s->_fieldEncodings.push_back(field.encoding->visit(*this));
+        s->_fieldEncodings.push_back(field.encoding->dispatch(*this));
     }
     return unique_ptr<binary::TypeEncoding>(s);
 }
@@ -260,6 +260,6 @@ unique_ptr<binary::TypeEncoding> binary::BinaryTypeEncodingSerializer::visitExtV
 {
     binary::ExtVectorEncoding* s = new binary::ExtVectorEncoding();
     s->_size = type.size;
-    s->_elementType = type.innerType->visit(*this);
+    s->_elementType = type.innerType->dispatch(*this);
     return unique_ptr<binary::TypeEncoding>(s);
 }
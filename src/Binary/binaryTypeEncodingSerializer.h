@@ -12,7 +12,7 @@ namespace binary {
      * \class BinaryTypeEncodingSerializer
      * \brief Applies the Visitor pattern for serializing \c typeEncoding::TypeEncoding objects in binary format.
      */
-class BinaryTypeEncodingSerializer : public ::Meta::TypeVisitor<unique_ptr<binary::TypeEncoding> > {
+class BinaryTypeEncodingSerializer final : public ::Meta::TypeVisitor<unique_ptr<binary::TypeEncoding> > {
 private:
     BinaryWriter _heapWriter;
 
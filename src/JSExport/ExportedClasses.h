@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Meta/MetaEntities.h"
+#include "Meta/TypeEntities.h"
+#include "Utils/StaticNameTable.h"
+#include <llvm/ADT/StringRef.h>
+
+namespace TypeScript {
+/*
+ * \brief Which classes and protocols the JSExport writer writes an export protocol for.
+ *
+ * The writer itself, and the subclasses which leave out the class methods their superclasses' export protocols
+ * declare in -jsexport-inheritance mode, ask the same predicates, so they can't disagree about a class.
+ */
+namespace ExportedClasses {
+// Written by hand, the TypeScript writer leaves them out as well
+constexpr auto hiddenClasses = StaticNameTable::makeSet({
+  "Protocol",
+  "NSString",
+  "NSData"
+});
+
+// Visited, but their export protocols aren't written, by Objective-C name
+constexpr auto unwrittenClasses = StaticNameTable::makeSet({
+  "NSResponder",
+  "NSColor",
+  "NSURLSession",
+  "NSURLSessionTask",
+  "NSURLSessionWebSocketTask"
+});
+
+// Unavailable in Swift, the writer doesn't visit them
+constexpr auto unavailableClasses = StaticNameTable::makeSet({
+  "NSDistantObjectRequest",
+  "AffineTransform"
+});
+
+inline bool isHidden(llvm::StringRef jsName)
+{
+  return hiddenClasses.contains(jsName);
+}
+
+inline bool isUnavailable(llvm::StringRef jsName)
+{
+  return unavailableClasses.contains(jsName);
+}
+
+// Whether the writer writes the export protocol of the class or protocol with these names
+inline bool writesExports(llvm::StringRef name, llvm::StringRef jsName)
+{
+  return !isHidden(jsName) && !unwrittenClasses.contains(name) && !isUnavailable(jsName) && !jsName.startswith("_");
+}
+
+inline bool writesExports(::Meta::Meta* meta)
+{
+  return (meta->is(::Meta::MetaType::Interface) || meta->is(::Meta::MetaType::Protocol)) && writesExports(meta->name, meta->jsName);
+}
+
+// Whether the export protocol of the class owning an inherited class method declares it already. Only the class
+// methods of written classes are, and initializers and methods returning instancetype have to be declared again by
+// every subclass. The class methods of protocols aren't merged into the export protocols of their classes.
+inline bool declaredByOwnerExports(bool ownerIsInterface, llvm::StringRef ownerName, llvm::StringRef ownerJsName, bool returnsInstance)
+{
+  return ownerIsInterface && writesExports(ownerName, ownerJsName) && !returnsInstance;
+}
+
+inline bool declaredByOwnerExports(::Meta::BaseClassMeta* owner, ::Meta::MethodMeta* method)
+{
+  bool returnsInstance = method->isInit() || method->signature[0]->is(::Meta::TypeInstancetype);
+  return declaredByOwnerExports(owner->is(::Meta::MetaType::Interface), owner->name, owner->jsName, returnsInstance);
+}
+}
+}
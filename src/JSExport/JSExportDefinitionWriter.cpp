@@ -1,14 +1,21 @@
 #include "TypeScript/DefinitionWriter.h"
+#include "TypeScript/InheritanceCache.h"
+#include "TypeScript/MemberLowering.h"
 #include "JSExportDefinitionWriter.h"
+#include "ExportedClasses.h"
 #include "Meta/MetaEntities.h"
 #include "Meta/MetaFactory.h"
 #include "Meta/Utils.h"
 #include "Meta/NameRetrieverVisitor.h"
+#include "TypeScript/OutputDirectories.h"
+#include "TypeScript/OutputFiles.h"
+#include "TypeScript/OutputScheduler.h"
+#include "Utils/StaticNameTable.h"
+#include "Utils/StringMatchers.h"
 #include "Utils/StringUtils.h"
 #include <algorithm>
 #include <clang/AST/DeclObjC.h>
 #include <iterator>
-#include <regex>
 #include "yaml-cpp/yaml.h"
 #include <cstdlib>
 
@@ -17,8 +24,11 @@ using namespace Meta;
 using namespace std;
 
 string JSExportDefinitionWriter::outputJSEFolder = "";
+bool JSExportDefinitionWriter::perFramework = false;
+size_t JSExportDefinitionWriter::maxFileSize = 0;
+bool JSExportDefinitionWriter::inheritExports = false;
 
-static unordered_set<string> hiddenNames = {
+static constexpr auto hiddenNames = StaticNameTable::makeSet({
   "alloc:",
   "allocWith:",
   "allocWithZone"
@@ -54,7 +64,7 @@ static unordered_set<string> hiddenNames = {
   "openURLs:withAppBundleIdentifier:options:additionalEventParamDescriptor:launchIdentifiers:",
   "getTasksWithCompletionHandler:",
   "getObjectValue:forString:errorDescription:"
-};
+});
 
 unordered_set<string> JSExportDefinitionWriter::writeInstanceInits = {
   "NSWindow",
@@ -77,7 +87,7 @@ unordered_set<string> JSExportDefinitionWriter::writeMethodImpls = {
 // Swift overlays certain framework classes, but when you try to extend them you get
 // the error "extension of protocol 'Error' cannot have an inheritance clause",
 // using the original name fixes this
-unordered_set<string> JSExportDefinitionWriter::overlaidClasses = {
+static constexpr auto overlaidClasses = StaticNameTable::makeSet({
   "Error",
   "URL",
   "URLQueryItem",
@@ -87,13 +97,12 @@ unordered_set<string> JSExportDefinitionWriter::overlaidClasses = {
   "URLRequest",
   "URLSessionTaskTransactionMetrics",
   "URLSessionWebSocketMessage"
-};
+});
 
-unordered_set<string> JSExportDefinitionWriter::hiddenClasses = {
-  "Protocol",
-  "NSString",
-  "NSData"
-};
+bool JSExportDefinitionWriter::isOverlaidClass(llvm::StringRef name)
+{
+  return overlaidClasses.contains(name);
+}
 
 static unordered_set<string> anyObjectProps = {
   "owner",
@@ -106,7 +115,7 @@ static unordered_set<string> anyObjectProps = {
 
 static string getTypeParametersStringOrEmpty(const clang::ObjCInterfaceDecl* interfaceDecl)
 {
-  ostringstream output;
+  EmissionBuffer output;
 
   if (clang::ObjCTypeParamList* typeParameters = interfaceDecl->getTypeParamListAsWritten()) {
     if (typeParameters->size()) {
@@ -141,7 +150,7 @@ void getClosedGenericsIfAnyJS(Type& type, vector<Type*>& params)
   } else if (type.is(TypeTypeArgument)) {
     TypeArgumentType* typeArg = &type.as<TypeArgumentType>();
     
-    if (typeArg->visit(NameRetrieverVisitor::instanceTs) != "") {
+    if (!typeArg->dispatch(NameRetrieverVisitor::instanceTs).empty()) {
       if (find(params.begin(), params.end(), typeArg) == params.end()) {
         params.push_back(typeArg);
       }
@@ -172,58 +181,6 @@ bool methodHasGenericParams(MethodMeta* method) {
   return hasGenericParams;
 }
 
-void JSExportDefinitionWriter::getInheritedMembersRecursive(InterfaceMeta* interface,
-                                                            CompoundMemberMap<MethodMeta>* staticMethods,
-                                                            CompoundMemberMap<MethodMeta>* instanceMethods,
-                                                            CompoundMemberMap<PropertyMeta>* staticProperties,
-                                                            CompoundMemberMap<PropertyMeta>* instanceProperties)
-{
-  auto base = interface->base;
-  if (!base) {
-    return;
-  }
-  
-  if (staticMethods) {
-    for (MethodMeta* method : base->staticMethods) {
-      if (staticMethods->find(method->jsName) == staticMethods->end()) {
-        staticMethods->emplace(method->jsName, make_pair(base, method));
-      }
-    }
-  }
-
-  if (instanceMethods) {
-    for (MethodMeta* method : base->instanceMethods) {
-      if (instanceMethods->find(method->jsName) == instanceMethods->end()) {
-        instanceMethods->emplace(method->jsName, make_pair(base, method));
-      }
-    }
-  }
-
-  if (staticProperties) {
-    for (PropertyMeta* property : base->staticProperties) {
-      if (staticProperties->find(property->jsName) == staticProperties->end()) {
-        staticProperties->emplace(property->jsName, make_pair(base, property));
-      }
-    }
-  }
-
-  if (instanceProperties) {
-    for (PropertyMeta* property : base->instanceProperties) {
-      if (instanceProperties->find(property->jsName) == instanceProperties->end()) {
-        instanceProperties->emplace(property->jsName, make_pair(base, property));
-      }
-    }
-  }
-
-  // accumulate...
-  unordered_set<ProtocolMeta*> protocols;
-  for (auto protocol : base->protocols) {
-    getProtocolMembersRecursive(protocol, staticMethods, instanceMethods, staticProperties, instanceProperties, protocols);
-  }
-
-  getInheritedMembersRecursive(base, staticMethods, instanceMethods, staticProperties, instanceProperties);
-}
-
 void JSExportDefinitionWriter::getProtocolMembersRecursive(ProtocolMeta* protocolMeta,
                                                            CompoundMemberMap<MethodMeta>* staticMethods,
                                                            CompoundMemberMap<MethodMeta>* instanceMethods,
@@ -287,7 +244,7 @@ string JSExportDefinitionWriter::getMethodReturnType(MethodMeta* meta, BaseClass
 
   if (!paramsGenerics.empty()) {
     for (size_t i = 0; i < paramsGenerics.size(); i++) {
-      string name = paramsGenerics[i]->visit(NameRetrieverVisitor::instanceTs);
+      llvm::StringRef name = paramsGenerics[i]->dispatch(NameRetrieverVisitor::instanceTs);
       if (find(ownerGenerics.begin(), ownerGenerics.end(), name) == ownerGenerics.end())
       {
         paramsGenerics.erase(paramsGenerics.begin() + i);
@@ -305,8 +262,8 @@ string JSExportDefinitionWriter::getMethodReturnType(MethodMeta* meta, BaseClass
     } else if (!paramsGenerics.empty()) {
       output += "<";
       for (size_t i = 0; i < paramsGenerics.size(); i++) {
-        auto name = paramsGenerics[i]->visit(NameRetrieverVisitor::instanceTs);
-        output += ::Meta::Type::nameForJSExport(name);
+        llvm::StringRef name = paramsGenerics[i]->dispatch(NameRetrieverVisitor::instanceTs);
+        output += ::Meta::Type::nameForJSExport(name.str());
         if (i < paramsGenerics.size() - 1) {
           output += ", ";
         }
@@ -322,23 +279,19 @@ string JSExportDefinitionWriter::getMethodReturnType(MethodMeta* meta, BaseClass
 
 string JSExportDefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, string keyword, string metaJsName)
 {
-  ostringstream output;
+  EmissionBuffer output;
 
-  if (hiddenNames.find(method->name) != hiddenNames.end()) {
+  if (hiddenNames.contains(method->name)) {
     return output.str();
   }
 
   const clang::ObjCMethodDecl& methodDecl = *clang::dyn_cast<clang::ObjCMethodDecl>(method->declaration);
-  auto& typeArg = *method->signature[0];
-
-  string retTypeString = Type::formatType(typeArg, methodDecl.getReturnType());
+  const LoweredMember& lowered = MemberLowering::lower(method, owner);
+  const LoweredSignature& signature = MemberLowering::lowerSignature(method, owner);
 
-  if (method->name == "URLFromPasteboard:" ||
-      method->name == "URLWithDataRepresentation:relativeToURL:") {
-    retTypeString = "NSURL";
-  }
+  string retTypeString = signature.returnType;
   
-  bool unavailableInSwift = method->getUnavailableInSwift(owner);
+  bool unavailableInSwift = lowered.unavailableInSwift;
 
   if (unavailableInSwift && !method->isRenamed) {
     output << "// unavailableInSwift ";
@@ -364,15 +317,15 @@ string JSExportDefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta*
   
   if (method->isInit()) {
     output << ::Meta::sanitizeIdentifierForSwift(method->builtName());
-    methodParams = method->getParamsAsString(owner, ParamCallType::Implementation);
+    methodParams = signature.implementationParams;
   }
-  else if (method->getParamsAsString(owner).find("JSValue") != string::npos) {
+  else if (signature.definitionParams.find("JSValue") != string::npos) {
     output << ::Meta::sanitizeIdentifierForSwift(method->jsName);
-    methodParams = method->getParamsAsString(owner);
+    methodParams = signature.definitionParams;
   }
   else {
     output << ::Meta::sanitizeIdentifierForSwift(method->jsName);
-    methodParams = method->getParamsAsString(owner);
+    methodParams = signature.definitionParams;
   }
   
   // Don't have clang::Qualifiers::OCL_Autoreleasing?
@@ -388,15 +341,14 @@ string JSExportDefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta*
   };
 
   if (autoreleasingMethods.find(method->getSelector()) != autoreleasingMethods.end()) {
-    std::regex re("UnsafeMutablePointer");
-    methodParams = std::regex_replace(methodParams, re, "AutoreleasingUnsafeMutablePointer");
+    methodParams = StringUtils::replaceString(methodParams, "UnsafeMutablePointer", "AutoreleasingUnsafeMutablePointer");
   }
   
   output << methodParams;
 
   if (retTypeString != "Void" && retTypeString != "") {
     output << " -> " + retTypeString;
-    output << method->getTypeNullability(owner);
+    output << signature.returnNullability;
   }
   
   string out = output.str();
@@ -421,7 +373,7 @@ string JSExportDefinitionWriter::writeMethod(CompoundMemberMap<MethodMeta>::valu
   string output;
   MethodMeta* method = methodPair.second.second;
   
-  if (hiddenNames.find(method->name) != hiddenNames.end()) {
+  if (hiddenNames.contains(method->name)) {
     return output;
   }
   
@@ -441,9 +393,9 @@ string JSExportDefinitionWriter::writeMethod(CompoundMemberMap<MethodMeta>::valu
 
 // MARK: - Write Property
 
-void JSExportDefinitionWriter::writeProperty(PropertyMeta* meta, BaseClassMeta* owner, InterfaceMeta* target, CompoundMemberMap<PropertyMeta> baseClassProperties)
+void JSExportDefinitionWriter::writeProperty(PropertyMeta* meta, BaseClassMeta* owner, InterfaceMeta* target, const CompoundMemberMap<PropertyMeta>& baseClassProperties)
 {
-  if (hiddenNames.find(meta->name) != hiddenNames.end()) {
+  if (hiddenNames.contains(meta->name)) {
     return;
   }
 
@@ -453,8 +405,7 @@ void JSExportDefinitionWriter::writeProperty(PropertyMeta* meta, BaseClassMeta*
     return;
   }
   
-  regex re(".*JSValue.*");
-  bool returnsJSValue = regex_match(propValue, re);
+  bool returnsJSValue = StringMatchers::lineContains(propValue, "JSValue");
 
   if (returnsJSValue) {
     _buffer << "// jsvalue ";
@@ -533,7 +484,8 @@ void JSExportDefinitionWriter::writeExtension(string protocolName, InterfaceMeta
 }
 
 void JSExportDefinitionWriter::writeMethodImpl(MethodMeta* method, BaseClassMeta* owner, bool isStatic) {
-  bool unavailableInSwift = method->getUnavailableInSwift(owner);
+  const LoweredSignature& signature = MemberLowering::lowerSignature(method, owner);
+  bool unavailableInSwift = MemberLowering::lower(method, owner).unavailableInSwift;
   
   if (unavailableInSwift && !method->isRenamed) {
     _buffer << "  /* ";
@@ -561,23 +513,11 @@ void JSExportDefinitionWriter::writeMethodImpl(MethodMeta* method, BaseClassMeta
 
   string implName = method->jsName;
   
-  auto methodImplParams = method->getParamsAsString(owner);
+  _buffer << "func " << implName << signature.definitionParams;
 
-  _buffer << "func " << implName << methodImplParams;
-
-  const clang::ObjCMethodDecl& methodDecl = *clang::dyn_cast<clang::ObjCMethodDecl>(method->declaration);
-  auto& first = *method->signature[0];
-  string retTypeString = Type::formatType(first, methodDecl.getReturnType());
+  _buffer << " -> " + signature.returnType;
   
-  if (method->name == "URLFromPasteboard:" ||
-      method->name == "URLWithDataRepresentation:relativeToURL:") {
-    retTypeString = "NSURL";
-  }
-
-  _buffer << " -> " + retTypeString;
-  
-  string typeNullabilityStr = method->getTypeNullability(owner);
-  _buffer << typeNullabilityStr;
+  _buffer << signature.returnNullability;
   
   _buffer << " {\n";
   _buffer << "    return ";
@@ -610,14 +550,15 @@ void JSExportDefinitionWriter::writeCreate(MethodMeta* method, BaseClassMeta* ow
     // Empty creates are filtered out earlier, but a few classes
     // have empty inits w/ a different name
     if (method->name == "fieldEditor") {
-      cerr << "Skipping empty non-`init` constructor: " << method->name << endl;
+      OutputScheduler::err() << "Skipping empty non-`init` constructor: " << method->name << endl;
       return;
     }
   }
   
-  auto methodImplParams = method->getParamsAsString(owner, ParamCallType::Implementation);
+  const LoweredMember& lowered = MemberLowering::lower(method, owner);
+  const LoweredSignature& signature = MemberLowering::lowerSignature(method, owner);
   auto methodCallParams = method->getParamsAsString(owner, ParamCallType::Call);
-  bool unavailableInSwift = method->getUnavailableInSwift(owner);
+  bool unavailableInSwift = lowered.unavailableInSwift;
   
   if (unavailableInSwift && !method->isRenamed) {
     _buffer << "  /* ";
@@ -640,21 +581,11 @@ void JSExportDefinitionWriter::writeCreate(MethodMeta* method, BaseClassMeta* ow
     }
   }
   
-  _buffer << "static func " << method->builtName() << methodImplParams;
+  _buffer << "static func " << method->builtName() << signature.implementationParams;
   
-  const clang::ObjCMethodDecl& methodDecl = *clang::dyn_cast<clang::ObjCMethodDecl>(method->declaration);
-  auto& first = *method->signature[0];
-  string retTypeString = Type::formatType(first, methodDecl.getReturnType());
+  _buffer << " -> " + signature.returnType;
   
-  if (method->name == "URLFromPasteboard:" ||
-      method->name == "URLWithDataRepresentation:relativeToURL:") {
-    retTypeString = "NSURL";
-  }
-
-  _buffer << " -> " + retTypeString;
-  
-  string typeNullabilityStr = method->getTypeNullability(owner);
-  _buffer << typeNullabilityStr;
+  _buffer << signature.returnNullability;
   
   _buffer << " {\n";
   
@@ -698,7 +629,7 @@ void JSExportDefinitionWriter::writeCreate(MethodMeta* method, BaseClassMeta* ow
 void JSExportDefinitionWriter::writeProto(ProtocolMeta* meta) {
   string protoName = meta->jsName;
 
-  bool isProtoClass = overlaidClasses.find(meta->jsName) != overlaidClasses.end();
+  bool isProtoClass = overlaidClasses.contains(meta->jsName);
 
   if (isProtoClass) {
     protoName = meta->name;
@@ -750,7 +681,7 @@ void JSExportDefinitionWriter::writeProto(string protocolName, InterfaceMeta* me
   
   if (meta->base) {
     string baseName = meta->base->jsName ;
-    bool isProtoClass = overlaidClasses.find(protocolName) != overlaidClasses.end();
+    bool isProtoClass = overlaidClasses.contains(protocolName);
     
     if (isProtoClass) {
       baseName = meta->name;
@@ -764,7 +695,7 @@ void JSExportDefinitionWriter::writeProto(string protocolName, InterfaceMeta* me
 
 string JSExportDefinitionWriter::writeProperty(PropertyMeta* meta, BaseClassMeta* owner)
 {
-  ostringstream output;
+  EmissionBuffer output;
   
   string name = meta->jsName;
 
@@ -869,8 +800,7 @@ void JSExportDefinitionWriter::visit(ProtocolMeta* meta)
   for (PropertyMeta* property : meta->instanceProperties) {
     string output = writeProperty(property, meta);
     if (output.size()) {
-      regex re(".*JSValue.*");
-      bool returnsJSValue = regex_match(output, re);
+      bool returnsJSValue = StringMatchers::lineContains(output, "JSValue");
 
       if (returnsJSValue) {
         _buffer << "// jsvalue ";
@@ -881,15 +811,14 @@ void JSExportDefinitionWriter::visit(ProtocolMeta* meta)
   }
   
   for (MethodMeta* method : meta->instanceMethods) {
-    if (hiddenNames.find(method->name) != hiddenNames.end()) {
+    if (hiddenNames.contains(method->name)) {
       continue;
     }
 
     string output = writeMethod(method, meta);
     
     if (output.size()) {
-      regex re(".*JSValue.*");
-      bool returnsJSValue = regex_match(output, re);
+      bool returnsJSValue = StringMatchers::lineContains(output, "JSValue");
 
       if (returnsJSValue
           && meta->jsName != "URLSessionWebSocketTask"
@@ -902,7 +831,7 @@ void JSExportDefinitionWriter::visit(ProtocolMeta* meta)
         _buffer << "  // " << output << " {" << endl;
 
         string body = "return try? self.handleDelegateInJS(\"" + method->name + "\", [itemIdentifier as Any, flag, toolbar]) as NSToolbarItem?";
-        string methodParams = method->getParamsAsString(meta);
+        string methodParams = MemberLowering::lowerSignature(method, meta).definitionParams;
         
         _buffer << "    //" << body << endl;
         _buffer << "    //" << methodParams << endl;
@@ -921,13 +850,7 @@ void JSExportDefinitionWriter::visit(ProtocolMeta* meta)
 
 void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
 {
-  if (meta->jsName == "NSDistantObjectRequest") {
-    // Unavailable classes
-    return;
-  }
-  
-  if (meta->jsName == "AffineTransform") {
-    // Unavailable classes
+  if (ExportedClasses::isUnavailable(meta->jsName)) {
     return;
   }
 
@@ -935,7 +858,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
   map<string, bool> addedConstructors = {};
 
   for (MethodMeta* method : meta->staticMethods) {
-    if (hiddenNames.find(method->name) != hiddenNames.end()) {
+    if (hiddenNames.contains(method->name)) {
       continue;
     }
 
@@ -956,7 +879,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
         continue;
       }
       
-      string builtName = method->builtName();
+      const string& builtName = method->builtName();
       
       if (addedConstructors[builtName]) {
         continue;
@@ -969,12 +892,12 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
   }
   
   if (meta->jsName == "WKWebView") {
-    cout << "";
+    OutputScheduler::out() << "";
   }
   
   CompoundMemberMap<MethodMeta> compoundInstanceMethods;
   for (MethodMeta* method : meta->instanceMethods) {
-    if (hiddenNames.find(method->name) != hiddenNames.end()) {
+    if (hiddenNames.contains(method->name)) {
       continue;
     }
     
@@ -1006,7 +929,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
     }
 
     if (isSetterForProperty) {
-      cerr << "Skipping " << method->name << "because it is a setter for a property" << endl;
+      OutputScheduler::err() << "Skipping " << method->name << "because it is a setter for a property" << endl;
       continue;
     }
     
@@ -1026,7 +949,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
   
   for (PropertyMeta* property : meta->instanceProperties) {
     if (ownInstanceProperties.find(property->name) != ownInstanceProperties.end()) {
-      cerr << "Skipping property with duplicated name: `" << property->name << "`" << endl;
+      OutputScheduler::err() << "Skipping property with duplicated name: `" << property->name << "`" << endl;
       continue;
     }
     
@@ -1034,7 +957,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
 
     if (interface->isSubclassOf("NSControl")) {
       if (interface->nameExistsInSuperclass(property->jsName, Method)) {
-        cerr << "Skipping property that exists as method in " << interface->jsName << " superclass: `" << property->jsName << "`" << endl;
+        OutputScheduler::err() << "Skipping property that exists as method in " << interface->jsName << " superclass: `" << property->jsName << "`" << endl;
         continue;
       }
       
@@ -1069,12 +992,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
   }
   
   unordered_set<ProtocolMeta*> inheritedProtocols;
-  CompoundMemberMap<MethodMeta> inheritedStaticMethods;
-  CompoundMemberMap<MethodMeta> inheritedInstanceMethods;
-  CompoundMemberMap<PropertyMeta> inheritedStaticProperties;
-  CompoundMemberMap<PropertyMeta> inheritedInstanceProperties;
-
-  getInheritedMembersRecursive(meta, &inheritedStaticMethods, &inheritedInstanceMethods, &inheritedStaticProperties, &inheritedInstanceProperties);
+  const CompoundMemberMap<MethodMeta>& inheritedStaticMethods = InheritanceCache::inheritedStaticMethods(meta, InheritanceCache::Key::JsName);
   
   for (auto& methodPair : inheritedStaticMethods) {
     MethodMeta* method = methodPair.second.second;
@@ -1088,10 +1006,16 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
       continue;
     }
     
+    // Inherited through the export protocol of the superclass declaring it, unless that one isn't written
+    if (inheritExports && ExportedClasses::declaredByOwnerExports(methodPair.second.first, method)) {
+      continue;
+    }
+    
     compoundStaticMethods.emplace(methodPair);
   }
   
-  if (compoundStaticMethods.empty() && compoundInstanceMethods.empty() &&
+  // The export protocols of the subclasses inherit from this one, so it's written even when empty
+  if (!inheritExports && compoundStaticMethods.empty() && compoundInstanceMethods.empty() &&
       ownStaticProperties.empty() && ownInstanceProperties.empty()) {
     return;
   }
@@ -1149,7 +1073,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
   
   string protocolName = meta->jsName;
   
-  bool isProtoClass = overlaidClasses.find(meta->jsName) != overlaidClasses.end();
+  bool isProtoClass = overlaidClasses.contains(meta->jsName);
   
   if (isProtoClass) {
     protocolName = meta->name;
@@ -1182,8 +1106,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
         _buffer << method->dumpDeclComments() << endl;
         _buffer << _docSet.getCommentFor(method, owner).toString("");
 
-        regex re(".*JSValue.*");
-        bool returnsJSValue = regex_match(output, re);
+        bool returnsJSValue = StringMatchers::lineContains(output, "JSValue");
         
         if (returnsJSValue
             && meta->jsName != "NSLayoutAnchor"
@@ -1241,7 +1164,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
       MethodMeta* method = methodPair.second.second;
       
       if (ownInstanceProperties.find(method->builtName()) != ownInstanceProperties.end()) {
-        cerr << "Skipping method `" << method->name << "` because property with same name exists " << endl;
+        OutputScheduler::err() << "Skipping method `" << method->name << "` because property with same name exists " << endl;
         continue;
       }
       
@@ -1252,8 +1175,7 @@ void JSExportDefinitionWriter::visit(InterfaceMeta* meta)
         _buffer << "  ";
         _buffer << _docSet.getCommentFor(methodPair.second.second, methodPair.second.first).toString("  ");
 
-        regex re(".*JSValue.*");
-        bool returnsJSValue = regex_match(output, re);
+        bool returnsJSValue = StringMatchers::lineContains(output, "JSValue");
         
         if (returnsJSValue
             && meta->jsName != "NSLayoutAnchor"
@@ -1378,22 +1300,16 @@ string JSExportDefinitionWriter::write()
 {
   _buffer.clear();
   _importedModules.clear();
+  _frameworkFile.clear();
+  _frameworkFilesCount = 0;
 
   for (::Meta::Meta* meta : _module.second) {
     meta->visit(this);
     
-    bool isNotHidden = hiddenClasses.find(meta->jsName) == hiddenClasses.end();
-    
-    if ((meta->is(MetaType::Interface) || meta->is(MetaType::Protocol))
-        && isNotHidden
-        && meta->name != "NSResponder"
-        && meta->name != "NSColor"
-        && meta->name != "NSURLSession"
-        && meta->name != "NSURLSessionTask"
-        && meta->name != "NSURLSessionWebSocketTask") {
+    if (ExportedClasses::writesExports(meta)) {
       string filename = meta->jsName + ".swift";
       
-      bool isProtoClass = overlaidClasses.find(meta->jsName) != overlaidClasses.end();
+      bool isProtoClass = overlaidClasses.contains(meta->jsName);
 
       if (isProtoClass) {
         filename = meta->name + ".swift";
@@ -1406,18 +1322,59 @@ string JSExportDefinitionWriter::write()
       writeJSExport(filename, meta, _module.first->Name);
     }
 
-    _buffer.str("");
     _buffer.clear();
   }
 
+  if (perFramework) {
+    writeFrameworkFile(_module.first->Name);
+  }
+
   return "";
 }
 
+string JSExportDefinitionWriter::writeImports(string frameworkName)
+{
+  string imports;
+  imports += "import AppKit\n";
+  imports += "import JavaScriptCore\n";
+
+  /*
+   - TODO: Ship an `objc-metadata-generator` binary with the framework,
+     so that users can generate files for the frameworks they need.
+   
+     This is because whether or not we include e.g. CoreSpotlight can effect whether
+     or not something in another framework like Foundation gets generated
+   
+     (e.g. `var contentAttributeSet: CSSearchableItemAttributeSet` in NSUserActivity)
+   
+     So even if the user doesn't want CoreSpotlight, Foundation will have this field,
+     which means ultimately users will want to generate their own bridge files
+  */
+  
+  imports += "import Quartz\n";
+  imports += "import AVKit\n";
+  imports += "import CoreMedia\n";
+  imports += "import CoreSpotlight\n";
+  imports += "import CoreImage\n";
+  imports += "import CoreGraphics\n";
+  imports += "import " + frameworkName + "\n";
+  return imports;
+}
+
 void JSExportDefinitionWriter::writeJSExport(string filename, ::Meta::Meta* meta, string frameworkName)
 {
-  auto buffer = _buffer.str();
+  llvm::StringRef buffer = _buffer.ref();
+  
+  if (buffer.empty() || buffer == "\n" || !ExportedClasses::writesExports(meta)) {
+    return;
+  }
   
-  if (buffer.empty() || buffer == "\n" || meta->jsName[0] == '_') {
+  if (perFramework) {
+    // Start the next file of the framework if this one would get too large
+    if (maxFileSize && !_frameworkFile.empty() && _frameworkFile.size() + buffer.size() > maxFileSize) {
+      writeFrameworkFile(frameworkName);
+    }
+    _frameworkFile.append(buffer.data(), buffer.size());
     return;
   }
   
@@ -1426,52 +1383,42 @@ void JSExportDefinitionWriter::writeJSExport(string filename, ::Meta::Meta* meta
     jsPath += "protocols/";
   }
   
-  string mkdirCmd = "mkdir -p '" + jsPath + "'";
-  const size_t mkdirReturn = system(mkdirCmd.c_str());
+  error_code mkdirError = OutputDirectories::create(jsPath);
   
-  if (mkdirReturn < 0)  {
-    cout << "Error creating directory using command: " << mkdirCmd << endl;
+  if (mkdirError) {
+    OutputScheduler::out() << "Error creating directory " << jsPath << ": " << mkdirError.message() << endl;
     return;
   }
 
-  error_code writeError;
-
-  llvm::raw_fd_ostream jsFile(jsPath + filename, writeError, llvm::sys::fs::F_Text);
+  string content = writeImports(frameworkName);
+  content.append(buffer.data(), buffer.size());
+  
+  error_code writeError = OutputFiles::write(jsPath + filename, content);
   
   if (writeError) {
-    cout << writeError.message();
+    OutputScheduler::out() << writeError.message();
     return;
   }
 
-  jsFile << "import AppKit\n";
-  jsFile << "import JavaScriptCore\n";
+//  cout << "Wrote " << frameworkName + "/" + filename << endl;
+}
 
-  /*
-   - TODO: Ship an `objc-metadata-generator` binary with the framework,
-     so that users can generate files for the frameworks they need.
-   
-     This is because whether or not we include e.g. CoreSpotlight can effect whether
-     or not something in another framework like Foundation gets generated
-   
-     (e.g. `var contentAttributeSet: CSSearchableItemAttributeSet` in NSUserActivity)
-   
-     So even if the user doesn't want CoreSpotlight, Foundation will have this field,
-     which means ultimately users will want to generate their own bridge files
-  */
+void JSExportDefinitionWriter::writeFrameworkFile(string frameworkName)
+{
+  if (_frameworkFile.empty()) {
+    return;
+  }
   
-  jsFile << "import Quartz\n";
-  jsFile << "import AVKit\n";
-  jsFile << "import CoreMedia\n";
-  jsFile << "import CoreSpotlight\n";
-  jsFile << "import CoreImage\n";
-  jsFile << "import CoreGraphics\n";
-  jsFile << "import " << frameworkName << "\n";
+  // AppKit/AppKit.swift, AppKit/AppKit2.swift, ...
+  _frameworkFilesCount++;
+  string jsPath = JSExportDefinitionWriter::outputJSEFolder + "/" + frameworkName + "/";
+  string filename = frameworkName + (_frameworkFilesCount > 1 ? std::to_string(_frameworkFilesCount) : "") + ".swift";
   
-  jsFile << buffer;
+  error_code writeError = OutputFiles::write(jsPath + filename, writeImports(frameworkName) + _frameworkFile);
+  _frameworkFile.clear();
   
-  jsFile.close();
-
-//  cout << "Wrote " << frameworkName + "/" + filename << endl;
+  if (writeError) {
+    OutputScheduler::out() << writeError.message();
+  }
 }
 }
-
@@ -1,9 +1,10 @@
 #pragma once
 
 #include "TypeScript/DocSetManager.h"
+#include "TypeScript/EmissionBuffer.h"
+#include "TypeScript/MemberTable.h"
 #include "Meta/MetaEntities.h"
 #include <Meta/TypeFactory.h>
-#include <sstream>
 #include <string>
 #include <unordered_set>
 
@@ -20,6 +21,8 @@ public:
   std::string write();
   
   void writeJSExport(std::string filename, ::Meta::Meta* meta, std::string frameworkName);
+  
+  void writeFrameworkFile(std::string frameworkName);
 
   virtual void visit(::Meta::InterfaceMeta* meta) override;
   
@@ -43,12 +46,18 @@ public:
   
   virtual void visit(::Meta::EnumConstantMeta* meta) override;
 
-  static std::unordered_set<std::string> hiddenClasses;
   static std::string outputJSEFolder;
+  // Write the definitions of a framework to as few files as possible instead of a file per class and protocol
+  static bool perFramework;
+  // Start the next file of a framework at about this many bytes, 0 for a single file
+  static size_t maxFileSize;
+  // Declare the inherited static methods only in the export protocol of the superclass, which the ones of its subclasses inherit from
+  static bool inheritExports;
   static std::string outputVueFolder;
-  static std::unordered_set<std::string> overlaidClasses;
   static std::unordered_set<std::string> writeInstanceInits;
   static std::unordered_set<std::string> writeMethodImpls;
+  // Swift overlays these framework classes, so the writers use their original NS names
+  static bool isOverlaidClass(llvm::StringRef name);
   
   std::pair<clang::Module*, std::vector<::Meta::Meta*> >& _module;
   ::Meta::TypeFactory& _typeFactory;
@@ -56,10 +65,10 @@ public:
 
 private:
   template <class Member>
-  using CompoundMemberMap = std::map<std::string, std::pair<::Meta::BaseClassMeta*, Member*> >;
+  using CompoundMemberMap = MemberTable<::Meta::BaseClassMeta, Member>;
   
   static std::string writeProperty(::Meta::PropertyMeta* meta, ::Meta::BaseClassMeta* owner);
-  void writeProperty(::Meta::PropertyMeta* meta, ::Meta::BaseClassMeta* owner, ::Meta::InterfaceMeta* target, CompoundMemberMap<::Meta::PropertyMeta> compoundProperties);
+  void writeProperty(::Meta::PropertyMeta* meta, ::Meta::BaseClassMeta* owner, ::Meta::InterfaceMeta* target, const CompoundMemberMap<::Meta::PropertyMeta>& compoundProperties);
   void writeClass(::Meta::InterfaceMeta* meta, CompoundMemberMap<::Meta::MethodMeta>* staticMethods, CompoundMemberMap<::Meta::MethodMeta>* instanceMethods);
   void writeProto(std::string protocolName, ::Meta::InterfaceMeta* meta);
   void writeProto(::Meta::ProtocolMeta* meta);
@@ -68,12 +77,6 @@ private:
 
   void writeExtension(std::string protocolName, ::Meta::InterfaceMeta* meta, CompoundMemberMap<::Meta::MethodMeta>* staticMethods, CompoundMemberMap<::Meta::MethodMeta>* instanceMethods);
 
-  static void getInheritedMembersRecursive(::Meta::InterfaceMeta* interface,
-                                           CompoundMemberMap<::Meta::MethodMeta>* staticMethods,
-                                           CompoundMemberMap<::Meta::MethodMeta>* instanceMethods,
-                                           CompoundMemberMap<::Meta::PropertyMeta>* staticProperties,
-                                           CompoundMemberMap<::Meta::PropertyMeta>* instanceProperties);
-  
   static void getProtocolMembersRecursive(::Meta::ProtocolMeta* protocol,
                                           CompoundMemberMap<::Meta::MethodMeta>* staticMethods,
                                           CompoundMemberMap<::Meta::MethodMeta>* instanceMethods,
@@ -81,6 +84,7 @@ private:
                                           CompoundMemberMap<::Meta::PropertyMeta>* instanceProperties,
                                           std::unordered_set<::Meta::ProtocolMeta*>& visitedProtocols);
   
+  static std::string writeImports(std::string frameworkName);
   static std::string getMethodReturnType(::Meta::MethodMeta* meta, ::Meta::BaseClassMeta* owner, size_t numArgs, const bool skipGenerics = false);
   static std::string writeSubclass(::Meta::InterfaceMeta* meta);
   static std::string writeMethod(::Meta::MethodMeta* meta, ::Meta::BaseClassMeta* owner, std::string keyword = "", std::string metaJsName = "");
@@ -88,6 +92,9 @@ private:
                                  const std::unordered_set<::Meta::ProtocolMeta*>& protocols, std::string keyword = "", std::string metaJsName = "");
   
   std::unordered_set<std::string> _importedModules;
-  std::ostringstream _buffer;
+  EmissionBuffer _buffer;
+  // The definitions of the current file of the framework in perFramework mode
+  std::string _frameworkFile;
+  size_t _frameworkFilesCount = 0;
 };
 }
@@ -2,6 +2,7 @@
 
 #include "CreationException.h"
 #include "MetaFactory.h"
+#include "Filters/ExceptionalMetasRules.h"
 #include "Filters/ModulesBlocklist.h"
 #include <clang/AST/RecursiveASTVisitor.h>
 #include <clang/Frontend/ASTUnit.h>
@@ -13,11 +14,12 @@
 namespace Meta {
 class DeclarationConverterVisitor : public clang::RecursiveASTVisitor<DeclarationConverterVisitor> {
 public:
-    explicit DeclarationConverterVisitor(clang::SourceManager& sourceManager, clang::HeaderSearch& headerSearch, bool verbose, ModulesBlocklist& modulesBlocklist)
+    explicit DeclarationConverterVisitor(clang::SourceManager& sourceManager, clang::HeaderSearch& headerSearch, bool verbose, ModulesBlocklist& modulesBlocklist, ExceptionalMetasRules& exceptionalMetasRules)
         : _metaContainer()
         , _metaFactory(sourceManager, headerSearch)
         , _verbose(verbose)
         , _modulesBlocklist(modulesBlocklist)
+        , _exceptionalMetasRules(exceptionalMetasRules)
     {
     }
 
@@ -74,10 +76,11 @@ private:
 
             Meta* meta = this->_metaFactory.create(*decl, /*resetCached*/ true);
             std::string whitelistRule, blocklistRule;
+            std::string moduleName = meta->module ? meta->module->getFullModuleName() : std::string();
                     
             if (meta->module &&
                 _modulesBlocklist.shouldBlocklist(
-                  meta->module->getFullModuleName(),
+                  moduleName,
                   meta->name.empty() ? meta->jsName : meta->name,
                   /*r*/whitelistRule,
                   /*r*/blocklistRule
@@ -86,6 +89,9 @@ private:
                 logSymbolAction("Blocklisted", meta, whitelistRule, blocklistRule);
             } else {
                 _metaContainer.push_back(meta);
+                if (meta->module) {
+                    _exceptionalMetasRules.record(meta, moduleName);
+                }
                 logSymbolAction("Included", meta, whitelistRule, blocklistRule);
             }
         } catch (MetaCreationException& e) {
@@ -143,5 +149,6 @@ private:
     MetaFactory _metaFactory;
     bool _verbose;
     ModulesBlocklist& _modulesBlocklist;
+    ExceptionalMetasRules& _exceptionalMetasRules;
 };
 } // namespace Meta
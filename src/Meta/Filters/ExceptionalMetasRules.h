@@ -0,0 +1,191 @@
+//
+//  ExceptionalMetasRules.h
+//  MetadataGenerator
+//
+
+#ifndef ExceptionalMetasRules_h
+#define ExceptionalMetasRules_h
+
+#include "Meta/MetaEntities.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Meta {
+
+// A fix-up for one specific declaration which the generic pipeline gets wrong.
+struct ExceptionalMetaRule {
+    enum class Action {
+        // Removes the instance methods whose jsName is `member`
+        RemoveInstanceMethod,
+        // Changes the return type of the static method with selector `member` to instancetype
+        ReturnInstancetype
+    };
+
+    MetaType metaType;
+    std::string module;
+    std::string symbol;
+    // Only for categories, the name of the interface they extend
+    std::string extendedInterface;
+    Action action;
+    std::string member;
+    bool iOSOnly;
+
+    std::string toString() const {
+        std::string symbolName = this->extendedInterface.empty() ? this->symbol : this->extendedInterface + "(" + this->symbol + ")";
+        return this->module + ":" + symbolName + " " + actionName(this->action) + " " + this->member;
+    }
+
+    static const char* actionName(Action action) {
+        switch (action) {
+        case Action::RemoveInstanceMethod:
+            return "remove-instance-method";
+        case Action::ReturnInstancetype:
+            return "return-instancetype";
+        }
+        return "";
+    }
+};
+
+// Holds the exceptional meta rules indexed by (module, symbol). The metas which a rule
+// targets are recorded while the declarations are collected, so applying the rules
+// later doesn't need to look at the rest of the container.
+//
+// Besides the built-in rules, more can be loaded from a file with one rule per line:
+//
+//   <interface|protocol|category> <module> <symbol> <action> <member> [ios-only]
+//
+// Categories are written as Interface(Category). Empty lines and lines starting with
+// '#' or '//' are ignored.
+class ExceptionalMetasRules {
+public:
+    ExceptionalMetasRules(const std::string& rulesFileName) {
+        // Exposes a method [UIResponder copy:] which conflicts with [NSObject copy] so we remove it
+        addRule({ MetaType::Category, "UIKit.UIResponder", "UIResponderStandardEditActions", "NSObject", ExceptionalMetaRule::Action::RemoveInstanceMethod, "copy", /*iOSOnly*/ true });
+        addRule({ MetaType::Protocol, "UIKit.UIResponder", "UIResponderStandardEditActions", "", ExceptionalMetaRule::Action::RemoveInstanceMethod, "copy", /*iOSOnly*/ true });
+
+        // Change the return type of [NSNull null] to instancetype
+        // TODO: remove the special handling of [NSNull null] from metadata generator and handle it in the runtime
+        addRule({ MetaType::Interface, "Foundation.NSNull", "NSNull", "", ExceptionalMetaRule::Action::ReturnInstancetype, "null", /*iOSOnly*/ false });
+
+        fillRulesFromFile(rulesFileName);
+    }
+
+    // Called for every collected meta with the full name of its module
+    void record(Meta* meta, const std::string& moduleName) {
+        auto it = this->_rulesBySymbol.find(key(moduleName, meta->name));
+        if (it == this->_rulesBySymbol.end()) {
+            return;
+        }
+
+        for (size_t ruleIndex : it->second) {
+            const ExceptionalMetaRule& rule = this->_rules[ruleIndex];
+            if (!meta->is(rule.metaType)) {
+                continue;
+            }
+            if (meta->is(MetaType::Category)) {
+                InterfaceMeta* extendedInterface = meta->as<CategoryMeta>().extendedInterface;
+                if (extendedInterface == nullptr || extendedInterface->name != rule.extendedInterface) {
+                    continue;
+                }
+            }
+            this->_targets[ruleIndex].push_back(meta);
+        }
+    }
+
+    const std::vector<ExceptionalMetaRule>& getRules() const {
+        return this->_rules;
+    }
+
+    const std::vector<Meta*>& getTargets(size_t ruleIndex) const {
+        return this->_targets[ruleIndex];
+    }
+
+private:
+    static std::string key(const std::string& moduleName, const std::string& symbolName) {
+        return moduleName + ":" + symbolName;
+    }
+
+    void addRule(ExceptionalMetaRule rule) {
+        this->_rulesBySymbol[key(rule.module, rule.symbol)].push_back(this->_rules.size());
+        this->_rules.push_back(std::move(rule));
+        this->_targets.emplace_back();
+    }
+
+    void fillRulesFromFile(const std::string& fileName) {
+        if (fileName.empty()) {
+            return;
+        }
+
+        std::ifstream ifs(fileName);
+        if (!ifs) {
+            std::stringstream ss;
+            ss << "Specified exceptional metas file " << fileName << " not found." << std::endl;
+            throw std::invalid_argument(ss.str());
+        }
+
+        std::string line;
+        while (std::getline(ifs, line)) {
+            if (line.empty() || line.compare(0, 1, "#") == 0 || line.compare(0, 2, "//") == 0) { // ignore comments and empty lines
+                continue;
+            }
+
+            std::istringstream fields(line);
+            std::string kind, module, symbol, action, member, platform;
+            fields >> kind >> module >> symbol >> action >> member >> platform;
+            if (kind.empty()) {
+                continue;
+            }
+
+            ExceptionalMetaRule rule;
+            rule.module = module;
+            rule.member = member;
+            rule.iOSOnly = platform == "ios-only";
+
+            if (kind == "interface") {
+                rule.metaType = MetaType::Interface;
+            } else if (kind == "protocol") {
+                rule.metaType = MetaType::Protocol;
+            } else if (kind == "category") {
+                rule.metaType = MetaType::Category;
+            } else {
+                throw std::invalid_argument("Invalid exceptional meta kind '" + kind + "' in line: " + line);
+            }
+
+            std::size_t parenthesis = symbol.find('(');
+            if (rule.metaType == MetaType::Category) {
+                if (parenthesis == std::string::npos || symbol.back() != ')') {
+                    throw std::invalid_argument("Categories must be written as Interface(Category) in line: " + line);
+                }
+                rule.extendedInterface = symbol.substr(0, parenthesis);
+                rule.symbol = symbol.substr(parenthesis + 1, symbol.size() - parenthesis - 2);
+            } else {
+                rule.symbol = symbol;
+            }
+
+            if (action == ExceptionalMetaRule::actionName(ExceptionalMetaRule::Action::RemoveInstanceMethod)) {
+                rule.action = ExceptionalMetaRule::Action::RemoveInstanceMethod;
+            } else if (action == ExceptionalMetaRule::actionName(ExceptionalMetaRule::Action::ReturnInstancetype)) {
+                rule.action = ExceptionalMetaRule::Action::ReturnInstancetype;
+            } else {
+                throw std::invalid_argument("Invalid exceptional meta action '" + action + "' in line: " + line);
+            }
+
+            if (rule.module.empty() || rule.symbol.empty() || rule.member.empty()) {
+                throw std::invalid_argument("Incomplete exceptional meta rule: " + line);
+            }
+
+            addRule(std::move(rule));
+        }
+    }
+
+    std::vector<ExceptionalMetaRule> _rules;
+    std::vector<std::vector<Meta*> > _targets;
+    std::unordered_map<std::string, std::vector<size_t> > _rulesBySymbol;
+};
+
+} // namespace Meta
+
+#endif /* ExceptionalMetasRules_h */
@@ -0,0 +1,170 @@
+#include "FilterPassManager.h"
+#include <chrono>
+#include <llvm/Support/ThreadPool.h>
+
+namespace Meta {
+using namespace std;
+
+// Cheap summary of what a filter can change in a top level meta: its jsName and
+// the identity of its members. Used to count the metas a pass has touched.
+static size_t fingerprint(Meta* meta)
+{
+    size_t hash = std::hash<string>()(meta->jsName);
+    auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    auto combineMembers = [&combine](const auto& members) {
+        combine(members.size());
+        for (const auto* member : members) {
+            combine(std::hash<const void*>()(member));
+        }
+    };
+
+    if (meta->is(MetaType::Interface) || meta->is(MetaType::Protocol) || meta->is(MetaType::Category)) {
+        BaseClassMeta& baseClass = meta->as<BaseClassMeta>();
+        combineMembers(baseClass.instanceMethods);
+        combineMembers(baseClass.staticMethods);
+        combineMembers(baseClass.instanceProperties);
+        combineMembers(baseClass.staticProperties);
+        combineMembers(baseClass.protocols);
+    }
+
+    return hash;
+}
+
+void FilterPassManager::addPass(FilterPass pass)
+{
+    assert(pass.run);
+    _passes.push_back(std::move(pass));
+}
+
+vector<FilterPass*> FilterPassManager::schedule()
+{
+    unordered_set<string> names;
+    for (FilterPass& pass : _passes) {
+        if (!names.insert(pass.name).second) {
+            throw logic_error("Filter pass " + pass.name + " is registered more than once");
+        }
+    }
+    for (FilterPass& pass : _passes) {
+        for (const string& dependency : pass.dependencies) {
+            if (names.find(dependency) == names.end()) {
+                throw logic_error("Filter pass " + pass.name + " depends on unknown pass " + dependency);
+            }
+        }
+    }
+
+    vector<FilterPass*> ordered;
+    unordered_set<string> scheduled;
+    while (ordered.size() < _passes.size()) {
+        bool progress = false;
+        for (FilterPass& pass : _passes) {
+            if (scheduled.find(pass.name) != scheduled.end()) {
+                continue;
+            }
+            bool ready = all_of(pass.dependencies.begin(), pass.dependencies.end(), [&scheduled](const string& dependency) {
+                return scheduled.find(dependency) != scheduled.end();
+            });
+            if (ready) {
+                ordered.push_back(&pass);
+                scheduled.insert(pass.name);
+                progress = true;
+                break;
+            }
+        }
+        if (!progress) {
+            throw logic_error("Filter passes have cyclic dependencies");
+        }
+    }
+    return ordered;
+}
+
+void FilterPassManager::runModulePass(FilterPass& pass, list<Meta*>& container)
+{
+    // Split the container by top level module, keeping the relative order of the metas
+    vector<pair<clang::Module*, list<Meta*> > > modules;
+    unordered_map<clang::Module*, size_t> moduleIndices;
+    for (Meta* meta : container) {
+        clang::Module* topLevelModule = meta->module->getTopLevelModule();
+        auto indexIt = moduleIndices.emplace(topLevelModule, modules.size());
+        if (indexIt.second) {
+            modules.push_back(make_pair(topLevelModule, list<Meta*>()));
+        }
+        modules[indexIt.first->second].second.push_back(meta);
+    }
+
+    {
+        llvm::ThreadPool pool;
+        vector<shared_future<void> > results;
+        results.reserve(modules.size());
+        for (pair<clang::Module*, list<Meta*> >& module : modules) {
+            results.push_back(pool.async([&pass, &module]() {
+                pass.run(module.first, module.second);
+            }));
+        }
+        pool.wait();
+
+        // Rethrow the first failure, if any
+        for (shared_future<void>& result : results) {
+            result.get();
+        }
+    }
+
+    unordered_set<Meta*> survivors;
+    for (pair<clang::Module*, list<Meta*> >& module : modules) {
+        survivors.insert(module.second.begin(), module.second.end());
+    }
+    if (survivors.size() != container.size()) {
+        container.remove_if([&survivors](Meta* meta) {
+            return survivors.find(meta) == survivors.end();
+        });
+    }
+}
+
+void FilterPassManager::run(list<Meta*>& container)
+{
+    for (FilterPass* pass : schedule()) {
+        unordered_map<Meta*, size_t> fingerprints;
+        fingerprints.reserve(container.size());
+        for (Meta* meta : container) {
+            fingerprints.emplace(meta, fingerprint(meta));
+        }
+
+        auto start = chrono::steady_clock::now();
+
+        if (pass->prepare) {
+            pass->prepare(container);
+        }
+
+        if (pass->scope == FilterScope::TopLevelModule) {
+            runModulePass(*pass, container);
+        } else {
+            pass->run(nullptr, container);
+        }
+
+        if (pass->finish) {
+            pass->finish(container);
+        }
+
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+        size_t touched = 0;
+        size_t kept = 0;
+        for (Meta* meta : container) {
+            auto fingerprintIt = fingerprints.find(meta);
+            if (fingerprintIt == fingerprints.end()) {
+                continue;
+            }
+            kept++;
+            if (fingerprintIt->second != fingerprint(meta)) {
+                touched++;
+            }
+        }
+
+        cout << "[Filter] " << pass->name << (pass->scope == FilterScope::TopLevelModule ? " (per module)" : "")
+             << ": " << elapsed.count() << " ms, "
+             << touched << " touched, "
+             << fingerprints.size() - kept << " removed." << endl;
+    }
+}
+}
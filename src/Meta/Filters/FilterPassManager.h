@@ -0,0 +1,44 @@
+#pragma once
+#include "Meta/MetaEntities.h"
+#include <functional>
+
+namespace Meta {
+enum class FilterScope {
+    // The pass sees the whole container at once
+    Global,
+    // The pass is invoked once per top level module with only that module's metas.
+    // Invocations for different modules run in parallel.
+    TopLevelModule
+};
+
+struct FilterPass {
+    typedef std::function<void(std::list<Meta*>& container)> ContainerFunction;
+    typedef std::function<void(clang::Module* topLevelModule, std::list<Meta*>& metas)> RunFunction;
+
+    std::string name;
+    FilterScope scope;
+    // Names of passes which have to run before this one
+    std::vector<std::string> dependencies;
+    // Optional. Runs on the calling thread with the whole container before run is invoked.
+    ContainerFunction prepare;
+    // For global passes topLevelModule is null and metas is the whole container
+    RunFunction run;
+    // Optional. Runs on the calling thread with the whole container after all run invocations.
+    ContainerFunction finish;
+};
+
+class FilterPassManager {
+public:
+    void addPass(FilterPass pass);
+
+    // Runs all passes in dependency order (ties keep the order in which they were added)
+    // and logs the time spent in each pass along with how many metas it touched and removed.
+    void run(std::list<Meta*>& container);
+
+private:
+    std::vector<FilterPass*> schedule();
+    void runModulePass(FilterPass& pass, std::list<Meta*>& container);
+
+    std::vector<FilterPass> _passes;
+};
+}
@@ -5,58 +5,52 @@
 namespace Meta {
 using namespace std;
 
-// Exposes a method [UIResponder copy:] which conflicts with [NSObject copy] so we remove it
-static void handleUIResponderStandardEditActions(list<Meta*>& container)
+static void removeInstanceMethods(Meta* meta, const string& jsName)
 {
-    for (Meta* meta : container) {
-        bool found = false;
-
-        if (meta->is(MetaType::Category)) {
-            InterfaceMeta* extendedInterface = meta->as<CategoryMeta>().extendedInterface;
-            if (meta->name == "UIResponderStandardEditActions" && meta->module->getFullModuleName() == "UIKit.UIResponder" && extendedInterface->name == "NSObject") {
-                found = true;
-            }
-        } else if (meta->is(MetaType::Protocol)) {
-            if (meta->name == "UIResponderStandardEditActions" && meta->module->getFullModuleName() == "UIKit.UIResponder") {
-                found = true;
-            }
-        }
-
-        if (found) {
-            auto& methods = meta->as<BaseClassMeta>().instanceMethods;
-            methods.erase(remove_if(methods.begin(), methods.end(), [](const MethodMeta* m) {
-                return m->jsName == "copy";
-            }),
-                methods.end());
+    auto& methods = meta->as<BaseClassMeta>().instanceMethods;
+    methods.erase(remove_if(methods.begin(), methods.end(), [&jsName](const MethodMeta* m) {
+        return m->jsName == jsName;
+    }),
+        methods.end());
+}
 
-            break;
+static void changeReturnTypeToInstancetype(Meta* meta, const string& selector)
+{
+    for (MethodMeta* method : meta->as<BaseClassMeta>().staticMethods) {
+        if (method->getSelector() == selector) {
+            method->signature[0] = TypeFactory::getInstancetype().get();
+            return;
         }
     }
 }
 
-// Change the return type of [NSNull null] to instancetype
-// TODO: remove the special handling of [NSNull null] from metadata generator and handle it in the runtime
-static void handleNSNullType(list<Meta*>& container)
+HandleExceptionalMetasFilter::HandleExceptionalMetasFilter(const ExceptionalMetasRules& rules)
+    : m_rules(rules)
 {
-    for (Meta* meta : container) {
-        if (meta->is(MetaType::Interface) && meta->name == "NSNull" && meta->module->getFullModuleName() == "Foundation.NSNull") {
-            InterfaceMeta& nsNullMeta = meta->as<InterfaceMeta>();
-            for (MethodMeta* method : nsNullMeta.staticMethods) {
-                if (method->getSelector() == "null") {
-                    method->signature[0] = TypeFactory::getInstancetype().get();
-                    return;
-                }
-            }
-        }
-    }
 }
 
+// The targets of every rule are recorded while collecting the declarations, so this
+// only visits the metas which need a fix-up instead of scanning the container per rule.
 void HandleExceptionalMetasFilter::filter(list<Meta*>& container)
 {
-    if (!Utils::isMacOSBuild) {
-      handleUIResponderStandardEditActions(container);
-    }
+    const vector<ExceptionalMetaRule>& rules = m_rules.getRules();
+
+    for (size_t i = 0; i < rules.size(); i++) {
+        const ExceptionalMetaRule& rule = rules[i];
+        if (rule.iOSOnly && Utils::isMacOSBuild) {
+            continue;
+        }
 
-    handleNSNullType(container);
+        for (Meta* meta : m_rules.getTargets(i)) {
+            switch (rule.action) {
+            case ExceptionalMetaRule::Action::RemoveInstanceMethod:
+                removeInstanceMethods(meta, rule.member);
+                break;
+            case ExceptionalMetaRule::Action::ReturnInstancetype:
+                changeReturnTypeToInstancetype(meta, rule.member);
+                break;
+            }
+        }
+    }
 }
 }
@@ -1,9 +1,15 @@
 #pragma once
 #include "Meta/MetaEntities.h"
+#include "Meta/Filters/ExceptionalMetasRules.h"
 
 namespace Meta {
 class HandleExceptionalMetasFilter {
 public:
+    HandleExceptionalMetasFilter(const ExceptionalMetasRules& rules);
+
     void filter(std::list<Meta*>& container);
+
+private:
+    const ExceptionalMetasRules& m_rules;
 };
-}
\ No newline at end of file
+}
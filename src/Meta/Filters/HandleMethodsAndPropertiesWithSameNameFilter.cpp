@@ -3,11 +3,17 @@
 namespace Meta {
 using namespace std;
 
-typedef  unordered_map<string, vector<MethodMeta*>>  MethodsStructure;
+// Methods with the same jsName and number of parameters, keyed by jsNameKey()
+typedef unordered_map<uint64_t, vector<MethodMeta*>> MethodsStructure;
 
-bool addMeta(MethodMeta* meta, MethodsStructure* methods, bool forceIfNameCollision)
+static uint64_t jsNameKey(uint32_t jsNameId, size_t signatureSize)
 {
-    pair<unordered_map<string, vector<MethodMeta*> >::iterator, bool> insertionResult = methods->emplace(meta->jsName + to_string(meta->signature.size()), vector<MethodMeta*>());
+    return (static_cast<uint64_t>(jsNameId) << 32) | static_cast<uint32_t>(signatureSize);
+}
+
+static bool addMeta(MethodMeta* meta, uint64_t key, MethodsStructure* methods, bool forceIfNameCollision)
+{
+    pair<MethodsStructure::iterator, bool> insertionResult = methods->emplace(key, vector<MethodMeta*>());
     
     if (insertionResult.second || forceIfNameCollision) {
         vector<MethodMeta*>& metasWithSameJsName = insertionResult.first->second;
@@ -16,18 +22,70 @@ bool addMeta(MethodMeta* meta, MethodsStructure* methods, bool forceIfNameCollis
     }
     return false;
 }
+
+size_t HandleMethodsAndPropertiesWithSameNameFilter::DeclSelectorKeyHash::operator()(const DeclSelectorKey& key) const
+{
+    size_t hash = std::hash<const void*>()(key.first);
+    return hash ^ (std::hash<const void*>()(key.second) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+}
     
 HandleMethodsAndPropertiesWithSameNameFilter::HandleMethodsAndPropertiesWithSameNameFilter(MetaFactory& metaFactory)
     : m_metaFactory(metaFactory)
 {
 }
 
-bool isAllUpper(std::string& s) {
-  return std::all_of(s.begin(), s.end(), [](unsigned char c){ return std::isupper(c); });
+// Resolves every clang lookup the filter needs once, so that the main pass only does
+// pointer-keyed lookups. Many interfaces share a superclass or protocols and ask it
+// about the same selectors. The lookups don't depend on what the filter changes
+// (it only edits metas), so their results can be computed up front.
+void HandleMethodsAndPropertiesWithSameNameFilter::buildIndices(list<Meta*>& container)
+{
+    for (Meta* meta : container) {
+        if (!meta->is(MetaType::Interface)) {
+            continue;
+        }
+
+        const clang::ObjCInterfaceDecl* decl = clang::cast<clang::ObjCInterfaceDecl>(meta->declaration);
+        clang::ObjCInterfaceDecl* parent = decl->getSuperClass();
+
+        for (clang::ObjCPropertyDecl* propertyDecl : decl->properties()) {
+            clang::Selector getterName = propertyDecl->getGetterName();
+            if (parent) {
+                auto inserted = m_methodsIndex.emplace(DeclSelectorKey(parent, getterName.getAsOpaquePtr()), nullptr);
+                if (inserted.second) {
+                    inserted.first->second = parent->lookupInstanceMethod(getterName);
+                }
+            }
+            for (clang::ObjCProtocolDecl* protocol : decl->protocols()) {
+                auto inserted = m_methodsIndex.emplace(DeclSelectorKey(protocol, getterName.getAsOpaquePtr()), nullptr);
+                if (inserted.second) {
+                    inserted.first->second = protocol->lookupInstanceMethod(getterName);
+                }
+            }
+        }
+
+        if (parent) {
+            for (clang::ObjCMethodDecl* methodDecl : decl->methods()) {
+                if (!(methodDecl->isClassMethod() && !methodDecl->isPropertyAccessor())) {
+                    continue;
+                }
+                auto inserted = m_classPropertyAccessors.emplace(DeclSelectorKey(parent, methodDecl->getSelector().getAsOpaquePtr()), false);
+                if (inserted.second) {
+                    inserted.first->second = parent->lookupPropertyAccessor(methodDecl->getSelector(), nullptr, true /*IsClassProperty*/) != nullptr;
+                }
+            }
+        }
+
+        for (MethodMeta* method : static_cast<InterfaceMeta*>(meta)->instanceMethods) {
+            m_jsNameIds.emplace(method->jsName, static_cast<uint32_t>(m_jsNameIds.size()));
+        }
+    }
 }
 
 void HandleMethodsAndPropertiesWithSameNameFilter::filter(list<Meta*>& container)
 {
+    buildIndices(container);
+
     for (Meta* meta : container) {
         if (meta->is(MetaType::Interface)) {
             InterfaceMeta* interface = static_cast<InterfaceMeta*>(meta);
@@ -35,13 +93,14 @@ void HandleMethodsAndPropertiesWithSameNameFilter::filter(list<Meta*>& container
             const clang::ObjCInterfaceDecl* decl = clang::cast<clang::ObjCInterfaceDecl>(meta->declaration);
 
             for (clang::ObjCPropertyDecl* propertyDecl : decl->properties()) {
+                const void* getterName = propertyDecl->getGetterName().getAsOpaquePtr();
                 if (clang::ObjCInterfaceDecl* parent = decl->getSuperClass()) {
-                    clang::ObjCMethodDecl* duplicate = parent->lookupInstanceMethod(propertyDecl->getGetterName());
+                    clang::ObjCMethodDecl* duplicate = m_methodsIndex.at(DeclSelectorKey(parent, getterName));
                     replaceMethodWithPropertyIfNecessary(duplicate, propertyDecl);
                 }
 
                 for (clang::ObjCProtocolDecl* protocol : decl->protocols()) {
-                    clang::ObjCMethodDecl* duplicate = protocol->lookupInstanceMethod(propertyDecl->getGetterName());
+                    clang::ObjCMethodDecl* duplicate = m_methodsIndex.at(DeclSelectorKey(protocol, getterName));
                     replaceMethodWithPropertyIfNecessary(duplicate, propertyDecl);
                 }
             }
@@ -52,7 +111,7 @@ void HandleMethodsAndPropertiesWithSameNameFilter::filter(list<Meta*>& container
                         continue;
                     }
 
-                    if (parent_decl->lookupPropertyAccessor(methodDecl->getSelector(), nullptr, true /*IsClassProperty*/)) {
+                    if (m_classPropertyAccessors.at(DeclSelectorKey(parent_decl, methodDecl->getSelector().getAsOpaquePtr()))) {
                         deleteStaticMethod(methodDecl, decl);
                     }
                 }
@@ -60,40 +119,42 @@ void HandleMethodsAndPropertiesWithSameNameFilter::filter(list<Meta*>& container
             
             MethodsStructure methods;
             for (MethodMeta* method : interface->instanceMethods) {
-                addMeta(method, &methods, true);
+                auto jsNameId = m_jsNameIds.find(method->jsName);
+                assert(jsNameId != m_jsNameIds.end());
+                addMeta(method, jsNameKey(jsNameId->second, method->signature.size()), &methods, true);
             }
             
             // resolve collisions
             
-            for (auto bucketIt = methods.begin(); bucketIt != methods.end(); ++bucketIt) {
-                vector<MethodMeta*>& metas = bucketIt->second;
-                if (metas.size() > 1) {
-                    for (vector<Meta*>::size_type i = 0; i < metas.size(); i++) {
-                      string originalJsName = metas[i]->jsName;
-                      string suffix = "";
-                    
-                      for (auto argLabel : metas[i]->argLabels) {
-                        if (argLabel == "_") {
-                          continue;
-                        }
-                        
-                        // URL -> url
-                        if (isAllUpper(argLabel)) {
-                          std::transform(argLabel.begin(), argLabel.end(), argLabel.begin(), ::tolower);
-                        }
-
-                        // url -> Url
-                        argLabel[0] = toupper(argLabel[0]);
-                        
-                        suffix += argLabel;
-                      }
-                    
+//            for (auto bucketIt = methods.begin(); bucketIt != methods.end(); ++bucketIt) {
+//                vector<MethodMeta*>& metas = bucketIt->second;
+//                if (metas.size() > 1) {
+//                    for (vector<Meta*>::size_type i = 0; i < metas.size(); i++) {
+//                      string originalJsName = metas[i]->jsName;
+//                      string suffix = "";
+//
+//                      for (auto argLabel : metas[i]->argLabels) {
+//                        if (argLabel == "_") {
+//                          continue;
+//                        }
+//
+//                        // URL -> url
+//                        if (isAllUpper(argLabel)) {
+//                          std::transform(argLabel.begin(), argLabel.end(), argLabel.begin(), ::tolower);
+//                        }
+//
+//                        // url -> Url
+//                        argLabel[0] = toupper(argLabel[0]);
+//
+//                        suffix += argLabel;
+//                      }
+//
 //                      metas[i]->jsName = MetaFactory::renameMeta(metas[i]->type, originalJsName, i);
 //                      cout << "Write IMPL for same-name swift fn: " << metas[i]->jsName << suffix << endl;
 //                      metas[i]->jsName += suffix;
-                    }
-                }
-            }
+//                    }
+//                }
+//            }
             
         }
     }
@@ -12,7 +12,21 @@ public:
     void filter(std::list<Meta*>& container);
 
 private:
+    // (owner decl, selector opaque pointer)
+    typedef std::pair<const void*, const void*> DeclSelectorKey;
+    struct DeclSelectorKeyHash {
+        size_t operator()(const DeclSelectorKey& key) const;
+    };
+
+    void buildIndices(std::list<Meta*>& container);
+
     MetaFactory& m_metaFactory;
+    // Result of owner->lookupInstanceMethod(selector)
+    std::unordered_map<DeclSelectorKey, clang::ObjCMethodDecl*, DeclSelectorKeyHash> m_methodsIndex;
+    // Whether owner->lookupPropertyAccessor(selector, nullptr, true) finds a class property accessor
+    std::unordered_map<DeclSelectorKey, bool, DeclSelectorKeyHash> m_classPropertyAccessors;
+    // Instance method jsNames interned to small integers
+    std::unordered_map<std::string, uint32_t> m_jsNameIds;
     void replaceMethodWithPropertyIfNecessary(clang::ObjCMethodDecl* duplicate, clang::ObjCPropertyDecl* propertyDecl);
     void deleteStaticMethod(const clang::ObjCMethodDecl* duplicateMethod, const clang::ObjCInterfaceDecl* owner);
 };
@@ -3,6 +3,7 @@
 //
 
 #include "MergeCategoriesFilter.h"
+#include <unordered_map>
 
 namespace Meta {
 using namespace std;
@@ -12,28 +13,49 @@ static bool isCategory(Meta* meta)
     return meta->is(MetaType::Category);
 }
 
+// Maps a member name to the slot it occupies in the interface's member vector.
+// Only the first occurrence of a name is indexed, which matches what a linear
+// find_if over the vector would return.
+typedef unordered_map<string, size_t> MemberSlots;
+
+struct InterfaceMemberSlots {
+    MemberSlots instanceProperties;
+    MemberSlots staticProperties;
+};
+
+template<class T>
+static MemberSlots buildSlots(const vector<T*>& v)
+{
+    MemberSlots slots;
+    slots.reserve(v.size());
+    for (size_t i = 0; i < v.size(); i++) {
+        slots.emplace(v[i]->name, i);
+    }
+    return slots;
+}
+
 // We shouldn't define more than 1 property with the same name
 // Whenever an extension redefines a property from the interface
 // We should choose the one which will eventually win.
 // Basically, the criteria is to choose the one that has not been deprecated or is newer
 template<class T>
-void addWithOverwrite(vector<T*>& v, T* newItem) {
-    auto equalNames = [&newItem](T* o) { return o->name == newItem->name; };
-
-    auto duplicateIt = find_if(v.begin(), v.end(), equalNames);
+void addWithOverwrite(vector<T*>& v, MemberSlots& slots, T* newItem) {
+    auto slotIt = slots.find(newItem->name);
 
-    if (duplicateIt != v.end()) {
-        T* oldItem = *duplicateIt;
+    if (slotIt != slots.end()) {
+        T*& duplicate = v[slotIt->second];
+        T* oldItem = duplicate;
 
         bool shouldOverwrite =
             newItem->deprecatedIn.isGreaterThanOrUnknown(oldItem->deprecatedIn) &&
             newItem->obsoletedIn.isGreaterThanOrUnknown(oldItem->obsoletedIn);
         
         if (shouldOverwrite) {
-            *duplicateIt = newItem;
+            duplicate = newItem;
         }
 
     } else {
+        slots.emplace(newItem->name, v.size());
         v.push_back(newItem);
     }
 }
@@ -41,6 +63,8 @@ void addWithOverwrite(vector<T*>& v, T* newItem) {
 void MergeCategoriesFilter::filter(list<Meta*>& container)
 {
     int mergedCategories = 0;
+    // Built lazily, once per extended interface, and kept in sync while merging
+    unordered_map<InterfaceMeta*, InterfaceMemberSlots> slotsByInterface;
     
     for (Meta* meta : container) {
         if (meta->is(MetaType::Category)) {
@@ -48,6 +72,15 @@ void MergeCategoriesFilter::filter(list<Meta*>& container)
             assert(category.extendedInterface != nullptr);
             InterfaceMeta& interface = *category.extendedInterface;
 
+            auto slotsIt = slotsByInterface.find(&interface);
+            if (slotsIt == slotsByInterface.end()) {
+                InterfaceMemberSlots slots;
+                slots.instanceProperties = buildSlots(interface.instanceProperties);
+                slots.staticProperties = buildSlots(interface.staticProperties);
+                slotsIt = slotsByInterface.emplace(&interface, std::move(slots)).first;
+            }
+            InterfaceMemberSlots& slots = slotsIt->second;
+
             for (auto& method : category.instanceMethods) {
                 interface.instanceMethods.push_back(method);
             }
@@ -57,11 +90,11 @@ void MergeCategoriesFilter::filter(list<Meta*>& container)
             }
 
             for (auto& property : category.instanceProperties) {
-                addWithOverwrite(interface.instanceProperties, property);
+                addWithOverwrite(interface.instanceProperties, slots.instanceProperties, property);
             }
 
             for (auto& property : category.staticProperties) {
-                addWithOverwrite(interface.staticProperties, property);
+                addWithOverwrite(interface.staticProperties, slots.staticProperties, property);
             }
 
             for (auto& protocol : category.protocols) {
@@ -8,6 +8,7 @@
 #ifndef ModulesBlocklist_h
 #define ModulesBlocklist_h
 
+#include <algorithm>
 #include <vector>
 #include <fstream>
 #include <sstream>
@@ -15,101 +16,215 @@
 #include <iostream>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <unordered_map>
 #include <llvm/ADT/StringRef.h>
 #include <llvm/Support/Regex.h>
 
 namespace Meta {
 
 class ModulesBlocklist {
-private:
+public:
     struct ModuleAndSymbolNamePatterns {
         std::string modulePattern;
         std::string symbolPattern;
-        
-        std::string toString() {
+
+        std::string toString() const {
             return this->modulePattern + ":" + this->symbolPattern;
         }
     };
     typedef std::vector<ModuleAndSymbolNamePatterns> ModuleAndSymbolNamePatternsList;
 
+private:
+    // Finds the patterns of a list whose module half matches a module name.
+    //
+    // Module patterns without wildcards are looked up in a hash map. The others are
+    // stored in a trie by their literal prefix (the part before the first wildcard),
+    // so only patterns whose prefix is a prefix of the module name reach the glob
+    // matcher.
+    class CompiledPatterns {
+    public:
+        explicit CompiledPatterns(const ModuleAndSymbolNamePatternsList& patterns)
+            : _patterns(patterns)
+            , _root(new TrieNode())
+        {
+            for (size_t i = 0; i < patterns.size(); i++) {
+                const std::string& modulePattern = patterns[i].modulePattern;
+                size_t wildcard = modulePattern.find_first_of("*?");
+                if (wildcard == std::string::npos) {
+                    // An empty module pattern matches any module, it ends up in the trie root
+                    if (modulePattern.empty()) {
+                        _root->patterns.push_back(i);
+                    } else {
+                        _exact[modulePattern].push_back(i);
+                    }
+                } else {
+                    TrieNode* node = _root.get();
+                    for (size_t c = 0; c < wildcard; c++) {
+                        std::unique_ptr<TrieNode>& child = node->children[modulePattern[c]];
+                        if (!child) {
+                            child.reset(new TrieNode());
+                        }
+                        node = child.get();
+                    }
+                    node->patterns.push_back(i);
+                }
+            }
+        }
+
+        // Indices of the patterns whose module half matches, in the order they were listed
+        std::vector<size_t> matchModule(const std::string& moduleName) const {
+            std::vector<size_t> result;
+
+            auto exactIt = _exact.find(moduleName);
+            if (exactIt != _exact.end()) {
+                result.insert(result.end(), exactIt->second.begin(), exactIt->second.end());
+            }
+
+            const TrieNode* node = _root.get();
+            for (size_t c = 0; node != nullptr; c++) {
+                for (size_t index : node->patterns) {
+                    const std::string& modulePattern = _patterns[index].modulePattern;
+                    if (modulePattern.empty() || match(modulePattern, moduleName)) {
+                        result.push_back(index);
+                    }
+                }
+                if (c == moduleName.size()) {
+                    break;
+                }
+                auto childIt = node->children.find(moduleName[c]);
+                node = childIt != node->children.end() ? childIt->second.get() : nullptr;
+            }
+
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+    private:
+        struct TrieNode {
+            std::unordered_map<char, std::unique_ptr<TrieNode> > children;
+            std::vector<size_t> patterns;
+        };
+
+        const ModuleAndSymbolNamePatternsList& _patterns;
+        std::unordered_map<std::string, std::vector<size_t> > _exact;
+        std::unique_ptr<TrieNode> _root;
+    };
+
+    // The patterns of both lists whose module half matches a given module
+    struct ModuleVerdict {
+        std::vector<size_t> whitelist;
+        std::vector<size_t> blocklist;
+    };
+
 public:
-    ModulesBlocklist(std::string& whitelistFileName, std::string& blocklistFileName) {
+    ModulesBlocklist(const std::string& whitelistFileName, const std::string& blocklistFileName) {
         this->_whitelistDefined = !whitelistFileName.empty();
         fillPatternsFromFile(whitelistFileName, /*r*/this->_whitelist);
         fillPatternsFromFile(blocklistFileName, /*r*/this->_blocklist);
+        compile();
     }
 
-    bool shouldBlocklist(std::string moduleName, std::string symbolName, std::string& enabledBy, std::string& disabledBy) {
-        auto findMatchingPattern = [&moduleName, &symbolName](ModuleAndSymbolNamePatternsList& v) {
-            return std::find_if(v.begin(), v.end(), [&moduleName, &symbolName](ModuleAndSymbolNamePatterns& item) {
-                return
-                    (item.modulePattern.empty() ||
-                     match(item.modulePattern.c_str(), moduleName.c_str()))
-                &&
-                    (item.symbolPattern.empty() ||
-                     match(item.symbolPattern.c_str(), symbolName.c_str()));
-            });
+    ModulesBlocklist(const ModuleAndSymbolNamePatternsList& whitelist, const ModuleAndSymbolNamePatternsList& blocklist, bool whitelistDefined)
+        : _whitelistDefined(whitelistDefined)
+        , _whitelist(whitelist)
+        , _blocklist(blocklist)
+    {
+        compile();
+    }
+
+    ModulesBlocklist(const ModulesBlocklist&) = delete;
+    void operator=(const ModulesBlocklist&) = delete;
+
+    bool shouldBlocklist(const std::string& moduleName, const std::string& symbolName, std::string& enabledBy, std::string& disabledBy) {
+        const ModuleVerdict& verdict = verdictFor(moduleName);
+
+        auto findMatchingPattern = [&symbolName](const std::vector<size_t>& candidates, const ModuleAndSymbolNamePatternsList& v) -> const ModuleAndSymbolNamePatterns* {
+            for (size_t index : candidates) {
+                const ModuleAndSymbolNamePatterns& item = v[index];
+                if (item.symbolPattern.empty() || match(item.symbolPattern, symbolName)) {
+                    return &item;
+                }
+            }
+            return nullptr;
         };
-        
+
         bool enabledByWhitelist = true;
         if (this->_whitelistDefined) {
-            auto it = findMatchingPattern(this->_whitelist);
-            enabledByWhitelist = it != this->_whitelist.end();
+            const ModuleAndSymbolNamePatterns* item = findMatchingPattern(verdict.whitelist, this->_whitelist);
+            enabledByWhitelist = item != nullptr;
             if (enabledByWhitelist) {
-                enabledBy = it->toString();
+                enabledBy = item->toString();
             }
         }
 
-        auto itBlocklist = findMatchingPattern(this->_blocklist);
-        bool disabledByBlocklist = itBlocklist != this->_blocklist.end();
+        const ModuleAndSymbolNamePatterns* itemBlocklist = findMatchingPattern(verdict.blocklist, this->_blocklist);
+        bool disabledByBlocklist = itemBlocklist != nullptr;
         if (disabledByBlocklist) {
-            disabledBy = itBlocklist->toString();
+            disabledBy = itemBlocklist->toString();
         }
 
         return disabledByBlocklist || !enabledByWhitelist;
     }
 
-private:
-    // Taken from https://www.geeksforgeeks.org/wildcard-character-matching/
-    static bool match(const char* pattern, const char* string)
+    // Wildcard match where '*' matches any sequence of characters and '?' matches exactly one.
+    // Backtracks only to the last '*' seen, so it runs in O(pattern * string) in the worst case.
+    static bool match(llvm::StringRef pattern, llvm::StringRef string)
     {
-        // If we reach at the end of both strings, we are done
-        if (*pattern == '\0' && *string == '\0')
-            return true;
-        
-        // pattern "*" matches everything, done checking
-        if (pattern[0] == '*' && pattern[1] == '\0')
-            return true;
-        
-        // Make sure that the characters after '*' are present
-        // in second string. This function assumes that the first
-        // string will not contain two consecutive '*'
-        if (*pattern == '*' && *(pattern+1) != '\0' && *string == '\0')
-            return false;
-      
-        // If the first string contains '?', or current characters
-        // of both strings match
-        if (*pattern == '?' || *pattern == *string)
-            return match(pattern+1, string+1);
-      
-        // If there is *, then there are two possibilities
-        // a) We consider current character of second string
-        // b) We ignore current character of second string.
-        if (*pattern == '*')
-            return match(pattern+1, string) || match(pattern, string+1);
-        return false;
+        size_t p = 0, s = 0;
+        size_t starP = llvm::StringRef::npos, starS = 0;
+
+        while (s < string.size()) {
+            if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == string[s])) {
+                p++;
+                s++;
+            } else if (p < pattern.size() && pattern[p] == '*') {
+                starP = p++;
+                starS = s;
+            } else if (starP != llvm::StringRef::npos) {
+                p = starP + 1;
+                s = ++starS;
+            } else {
+                return false;
+            }
+        }
+
+        while (p < pattern.size() && pattern[p] == '*') {
+            p++;
+        }
+        return p == pattern.size();
     }
-    
+
+private:
+    void compile() {
+        this->_compiledWhitelist.reset(new CompiledPatterns(this->_whitelist));
+        this->_compiledBlocklist.reset(new CompiledPatterns(this->_blocklist));
+    }
+
+    const ModuleVerdict& verdictFor(const std::string& moduleName) {
+        auto it = this->_verdicts.find(moduleName);
+        if (it != this->_verdicts.end()) {
+            return it->second;
+        }
+
+        ModuleVerdict& verdict = this->_verdicts[moduleName];
+        if (this->_whitelistDefined) {
+            verdict.whitelist = this->_compiledWhitelist->matchModule(moduleName);
+        }
+        verdict.blocklist = this->_compiledBlocklist->matchModule(moduleName);
+        return verdict;
+    }
+
     static void fillPatternsFromFile(const std::string& opt, ModuleAndSymbolNamePatternsList &regexList) {
         if (!opt.empty()) {
             std::ifstream ifs(opt);
-            
+
             if (!ifs) {
                 std::stringstream ss;
                 ss << "Specified patterns list file " << opt << " not found." << std::endl;
                 throw std::invalid_argument(ss.str());
             }
-            
+
             std::string line;
             while (std::getline(ifs, line)) {
                 if (line.size() && strncmp(line.c_str(), "#", 1) != 0 && strncmp(line.c_str(), "//", 2) != 0) { // ignore comments and empty lines
@@ -125,6 +240,10 @@ private:
     bool _whitelistDefined = false;
     ModuleAndSymbolNamePatternsList _whitelist;
     ModuleAndSymbolNamePatternsList _blocklist;
+    std::unique_ptr<CompiledPatterns> _compiledWhitelist;
+    std::unique_ptr<CompiledPatterns> _compiledBlocklist;
+    // Symbols are checked module by module, so the module half of the patterns is only matched once per module
+    std::unordered_map<std::string, ModuleVerdict> _verdicts;
 };
 
 } // namespace Meta
@@ -22,7 +22,7 @@ static bool arePropertiesEqual(PropertyMeta& prop1, PropertyMeta& prop2)
     return false;
 }
 
-static void removeDuplicateMethods(vector<MethodMeta*>& from, vector<MethodMeta*>& duplicates)
+static void removeDuplicateMethods(vector<MethodMeta*>& from, const vector<MethodMeta*>& duplicates)
 {
     for (MethodMeta* dupMethod : duplicates) {
         from.erase(remove_if(from.begin(),
@@ -34,7 +34,7 @@ static void removeDuplicateMethods(vector<MethodMeta*>& from, vector<MethodMeta*
     }
 }
 
-static void removeDuplicateProperties(vector<PropertyMeta*>& from, vector<PropertyMeta*>& duplicates)
+static void removeDuplicateProperties(vector<PropertyMeta*>& from, const vector<PropertyMeta*>& duplicates)
 {
     for (PropertyMeta* dupProperty : duplicates) {
         from.erase(remove_if(from.begin(),
@@ -46,18 +46,28 @@ static void removeDuplicateProperties(vector<PropertyMeta*>& from, vector<Proper
     }
 }
 
-static void removeDuplicateMembersFromChild(BaseClassMeta* child, BaseClassMeta* parent)
+static void removeDuplicateMembersFromChild(BaseClassMeta* child, const vector<MethodMeta*>& staticMethods, const vector<MethodMeta*>& instanceMethods, const vector<PropertyMeta*>& instanceProperties, const vector<PropertyMeta*>& staticProperties)
 {
-    removeDuplicateMethods(child->staticMethods, parent->staticMethods);
-    removeDuplicateMethods(child->instanceMethods, parent->instanceMethods);
-    removeDuplicateProperties(child->instanceProperties, parent->instanceProperties);
-    removeDuplicateProperties(child->staticProperties, parent->staticProperties);
+    removeDuplicateMethods(child->staticMethods, staticMethods);
+    removeDuplicateMethods(child->instanceMethods, instanceMethods);
+    removeDuplicateProperties(child->instanceProperties, instanceProperties);
+    removeDuplicateProperties(child->staticProperties, staticProperties);
 }
 
-static void processBaseClassAndHierarchyOf(BaseClassMeta* child, BaseClassMeta* parent)
+const RemoveDuplicateMembersFilter::Members* RemoveDuplicateMembersFilter::snapshotOf(BaseClassMeta* meta) const
+{
+    auto it = _snapshot.find(meta);
+    return it != _snapshot.end() ? &it->second : nullptr;
+}
+
+void RemoveDuplicateMembersFilter::processBaseClassAndHierarchyOf(BaseClassMeta* child, BaseClassMeta* parent)
 {
     if (child != parent) {
-        removeDuplicateMembersFromChild(child, parent);
+        if (const Members* members = snapshotOf(parent)) {
+            removeDuplicateMembersFromChild(child, members->staticMethods, members->instanceMethods, members->instanceProperties, members->staticProperties);
+        } else {
+            removeDuplicateMembersFromChild(child, parent->staticMethods, parent->instanceMethods, parent->instanceProperties, parent->staticProperties);
+        }
     }
     for (ProtocolMeta* protocol : parent->protocols) {
         processBaseClassAndHierarchyOf(child, protocol);
@@ -70,6 +80,25 @@ static void processBaseClassAndHierarchyOf(BaseClassMeta* child, BaseClassMeta*
     }
 }
 
+// Removing a member from a class never changes what its descendants lose: anything
+// equal to it is also equal to the ancestor member that caused its removal. Reading
+// the pre-filter members of the hierarchy therefore gives the same result as the
+// sequential in-place pass.
+void RemoveDuplicateMembersFilter::snapshot(const list<Meta*>& container)
+{
+    _snapshot.clear();
+    for (Meta* meta : container) {
+        if (meta->is(MetaType::Interface) || meta->is(MetaType::Protocol)) {
+            BaseClassMeta* baseClass = &meta->as<BaseClassMeta>();
+            Members& members = _snapshot[baseClass];
+            members.instanceMethods = baseClass->instanceMethods;
+            members.staticMethods = baseClass->staticMethods;
+            members.instanceProperties = baseClass->instanceProperties;
+            members.staticProperties = baseClass->staticProperties;
+        }
+    }
+}
+
 void RemoveDuplicateMembersFilter::filter(list<Meta*>& container)
 {
     for (Meta* meta : container) {
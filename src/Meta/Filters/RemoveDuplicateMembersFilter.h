@@ -4,6 +4,24 @@
 namespace Meta {
 class RemoveDuplicateMembersFilter {
 public:
+    // Records the members of every class in the container. Once taken, base classes
+    // and protocols are read from the snapshot only, which lets filter() run on the
+    // metas of different modules concurrently.
+    void snapshot(const std::list<Meta*>& container);
+
     void filter(std::list<Meta*>& container);
+
+private:
+    struct Members {
+        std::vector<MethodMeta*> instanceMethods;
+        std::vector<MethodMeta*> staticMethods;
+        std::vector<PropertyMeta*> instanceProperties;
+        std::vector<PropertyMeta*> staticProperties;
+    };
+
+    const Members* snapshotOf(BaseClassMeta* meta) const;
+    void processBaseClassAndHierarchyOf(BaseClassMeta* child, BaseClassMeta* parent);
+
+    std::unordered_map<BaseClassMeta*, Members> _snapshot;
 };
-}
\ No newline at end of file
+}
@@ -3,7 +3,9 @@
 //
 
 #include "ResolveGlobalNamesCollisionsFilter.h"
+#include "Meta/JsNameOrder.h"
 #include "Meta/MetaFactory.h"
+#include <llvm/Support/ThreadPool.h>
 
 namespace Meta {
 using namespace std;
@@ -38,42 +40,138 @@ static bool metasComparerByPriority(Meta* meta1, Meta* meta2)
 }
 void ResolveGlobalNamesCollisionsFilter::filter(list<Meta*>& container)
 {
+    group(container);
 
+    for (auto modulesIt = _modules.begin(); modulesIt != _modules.end(); ++modulesIt) {
+        resolveCollisions(modulesIt->first);
+    }
+
+    logStatistics();
+}
+
+void ResolveGlobalNamesCollisionsFilter::group(const list<Meta*>& container)
+{
     // order meta objects by modules and names
     for (Meta* meta : container) {
         addMeta(meta, true);
     }
+}
+
+void ResolveGlobalNamesCollisionsFilter::resolveCollisions(clang::Module* topLevelModule)
+{
+    auto moduleIt = _modules.find(topLevelModule);
+    if (moduleIt == _modules.end()) {
+        return;
+    }
+    unordered_map<string, vector<Meta*> >& moduleGlobalTable = moduleIt->second;
 
     // resolve collisions
     vector<Meta*> conflictingMetas;
-    for (auto modulesIt = _modules.begin(); modulesIt != _modules.end(); ++modulesIt) {
-        for (auto bucketIt = modulesIt->second.begin(); bucketIt != modulesIt->second.end(); ++bucketIt) {
-            vector<Meta*>& metas = bucketIt->second;
-            if (metas.size() > 1) {
-                sort(metas.begin(), metas.end(), metasComparerByPriority);
-                for (vector<Meta*>::size_type i = 1; i < metas.size(); i++) {
-                    conflictingMetas.push_back(metas[i]);
-                }
-                metas.resize(1); // leave only the meta with the highest priority in the bucket
+    for (auto bucketIt = moduleGlobalTable.begin(); bucketIt != moduleGlobalTable.end(); ++bucketIt) {
+        vector<Meta*>& metas = bucketIt->second;
+        if (metas.size() > 1) {
+            sort(metas.begin(), metas.end(), metasComparerByPriority);
+            for (vector<Meta*>::size_type i = 1; i < metas.size(); i++) {
+                conflictingMetas.push_back(metas[i]);
             }
+            metas.resize(1); // leave only the meta with the highest priority in the bucket
+            _collidingBuckets++;
         }
     }
 
+    if (conflictingMetas.empty()) {
+        return;
+    }
+
+    // Renaming only ever adds names, so make room for all of them at once
+    moduleGlobalTable.reserve(moduleGlobalTable.size() + conflictingMetas.size());
+
+    // Names taken by renames only accumulate, so the first free index for a given
+    // base name can never go down. Remember it to skip the indices already tried.
+    unordered_map<string, int> nextIndexByBaseName;
+    size_t attempts = 0;
+
     for (Meta* meta : conflictingMetas) {
-        int index = 1;
         string originalJsName = meta->jsName;
-        
-        do {
-            meta->jsName = MetaFactory::renameMeta(meta->type, originalJsName, index);
+        int& index = nextIndexByBaseName.emplace(MetaFactory::renameMeta(meta->type, originalJsName, 1), 1).first->second;
+
+        while (true) {
+            string candidate = MetaFactory::renameMeta(meta->type, originalJsName, index);
             index++;
-        } while (!addMeta(meta, false));
+            attempts++;
+            if (moduleGlobalTable.find(candidate) == moduleGlobalTable.end()) {
+                meta->jsName = candidate;
+                moduleGlobalTable.emplace(std::move(candidate), vector<Meta*>{ meta });
+                break;
+            }
+        }
     }
+
+    _renamedMetas += conflictingMetas.size();
+    _renameAttempts += attempts;
+}
+
+void ResolveGlobalNamesCollisionsFilter::logStatistics() const
+{
+    cout << "Resolved " << _collidingBuckets << " global name collisions by renaming " << _renamedMetas << " declarations (" << _renameAttempts << " attempts)." << endl;
+}
+
+unique_ptr<pair<ResolveGlobalNamesCollisionsFilter::MetasByModules, ResolveGlobalNamesCollisionsFilter::InterfacesByName> > ResolveGlobalNamesCollisionsFilter::getResult()
+{
+    unique_ptr<pair<MetasByModules, InterfacesByName> > result = llvm::make_unique<pair<MetasByModules, InterfacesByName> >(MetasByModules(), InterfacesByName());
+    MetasByModules& metasByModules = result->first;
+    InterfacesByName& interfacesByName = result->second;
+    
+    // Sort modules by name to avoid randomizing metadata
+    typedef vector<ModulesStructure::value_type*> ModulesVector;
+    ModulesVector v;
+    v.reserve(_modules.size());
+    transform(_modules.begin(), _modules.end(), back_inserter(v), [](ModulesStructure::value_type& it) {
+        return &it;
+    });
+    sort(v.begin(), v.end(), [](const ModulesVector::value_type& a, const ModulesVector::value_type&  b) {
+        return a->first->Name.compare(b->first->Name) < 0;
+    });
+
+    metasByModules.reserve(v.size());
+    for (auto& mptr : v) {
+        auto& module = *mptr;
+        metasByModules.emplace_back(module.first, vector<Meta*>());
+        vector<Meta*>& moduleMetas = metasByModules.back().second;
+        moduleMetas.reserve(module.second.size());
+        for (const auto& metas : module.second) {
+            assert(metas.second.size() == 1);
+            for (Meta* meta : metas.second) {
+                moduleMetas.push_back(meta);
+                if (meta->is(MetaType::Interface)) {
+                    interfacesByName.insert({ { meta->name, &meta->as<InterfaceMeta>() } });
+                }
+            }
+        }
+    }
+
+    // jsNames are unique within a module at this point, so the order doesn't
+    // depend on the sort algorithm and modules can be sorted independently
+    llvm::ThreadPool pool;
+    for (auto& modulePair : metasByModules) {
+        vector<Meta*>* moduleMetas = &modulePair.second;
+        pool.async([moduleMetas]() {
+            sortByJsName(*moduleMetas);
+        });
+    }
+    pool.wait();
+
+    return result;
 }
 
 bool ResolveGlobalNamesCollisionsFilter::addMeta(Meta* meta, bool forceIfNameCollision)
 {
     pair<ModulesStructure::iterator, bool> insertionResult1 = _modules.emplace(meta->module->getTopLevelModule(), unordered_map<string, vector<Meta*> >());
-    unordered_map<string, vector<Meta*> >& moduleGlobalTable = insertionResult1.first->second;
+    return addMeta(insertionResult1.first->second, meta, forceIfNameCollision);
+}
+
+bool ResolveGlobalNamesCollisionsFilter::addMeta(unordered_map<string, vector<Meta*> >& moduleGlobalTable, Meta* meta, bool forceIfNameCollision)
+{
     pair<unordered_map<string, vector<Meta*> >::iterator, bool> insertionResult2 = moduleGlobalTable.emplace(meta->jsName, vector<Meta*>());
     if (insertionResult2.second || forceIfNameCollision) {
         vector<Meta*>& metasWithSameJsName = insertionResult2.first->second;
@@ -3,13 +3,9 @@
 //
 #pragma once
 #include "Meta/MetaEntities.h"
+#include <atomic>
 
 namespace Meta {
-static bool campareMetasByJsName(Meta* meta1, Meta* meta2)
-{
-    return meta1->jsName < meta2->jsName;
-}
-
 class ResolveGlobalNamesCollisionsFilter {
 public:
     typedef std::vector<std::pair<clang::Module*, std::vector<Meta*> > > MetasByModules;
@@ -18,44 +14,27 @@ public:
 
     void filter(std::list<Meta*>& container);
 
-    std::unique_ptr<std::pair<MetasByModules, InterfacesByName> > getResult()
-    {
-        std::unique_ptr<std::pair<MetasByModules, InterfacesByName> > result = llvm::make_unique<std::pair<MetasByModules, InterfacesByName> >(MetasByModules(), InterfacesByName());
-        MetasByModules& metasByModules = result->first;
-        InterfacesByName& interfacesByName = result->second;
-        
-        // Sort modules by name to avoid randomizing metadata
-        typedef std::vector<ModulesStructure::value_type*> ModulesVector;
-        ModulesVector v;
-        std::transform(_modules.begin(), _modules.end(), std::back_inserter(v), [](ModulesStructure::value_type& it) {
-            return &it;
-        });
-        std::sort(v.begin(), v.end(), [](const ModulesVector::value_type& a, const ModulesVector::value_type&  b) {
-            return a->first->Name.compare(b->first->Name) < 0;
-        });
-
-        for (auto& mptr : v) {
-            auto& module = *mptr;
-            std::pair<clang::Module*, std::vector<Meta*> > modulePair(module.first, std::vector<Meta*>());
-          for (const std::pair<std::string, std::vector<Meta*> > metas : module.second) {
-                assert(metas.second.size() == 1);
-                for (Meta* meta : metas.second) {
-                    modulePair.second.push_back(meta);
-                    if (meta->is(MetaType::Interface)) {
-                        interfacesByName.insert({ { meta->name, &meta->as<InterfaceMeta>() } });
-                    }
-                }
-            }
-            std::sort(modulePair.second.begin(), modulePair.second.end(), campareMetasByJsName);
-            metasByModules.push_back(modulePair);
-        }
-
-        return result;
-    }
+    // Buckets the metas by top level module and jsName
+    void group(const std::list<Meta*>& container);
+
+    // Renames the colliding metas of one top level module. Only touches the bucket
+    // table of that module, so different modules can be resolved concurrently
+    // once group() has run.
+    void resolveCollisions(clang::Module* topLevelModule);
+
+    // Prints how many name collisions were found and how many renames they took
+    void logStatistics() const;
+
+    std::unique_ptr<std::pair<MetasByModules, InterfacesByName> > getResult();
 
 private:
     bool addMeta(Meta* meta, bool forceIfNameCollision = false);
+    bool addMeta(std::unordered_map<std::string, std::vector<Meta*> >& moduleGlobalTable, Meta* meta, bool forceIfNameCollision);
 
     ModulesStructure _modules;
+
+    std::atomic<size_t> _collidingBuckets { 0 };
+    std::atomic<size_t> _renamedMetas { 0 };
+    std::atomic<size_t> _renameAttempts { 0 };
 };
 }
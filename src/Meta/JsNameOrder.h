@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Meta {
+/*
+ * \brief Sorting metas by jsName on keys computed once per meta instead of comparing the names in every comparison.
+ *
+ * A key starts with the first 8 bytes of the name packed big-endian, which orders the same way as comparing
+ * the strings themselves, so the full names are only compared on ties. std::sort gets the same answer for every
+ * comparison it would get from comparing the names, and therefore leaves the metas in the same order.
+ */
+namespace JsNameOrder {
+    static inline uint64_t prefixOf(const std::string& name)
+    {
+        uint64_t prefix = 0;
+        for (size_t i = 0; i < sizeof(uint64_t); i++) {
+            prefix <<= 8;
+            if (i < name.size()) {
+                prefix |= static_cast<unsigned char>(name[i]);
+            }
+        }
+        return prefix;
+    }
+
+    template <class T>
+    struct Key {
+        uint64_t prefix;
+        // The lowercased name for case-insensitive orders, empty otherwise
+        std::string foldedName;
+        T* meta;
+    };
+
+    template <class T>
+    static void sortByKeys(std::vector<T*>& metas, bool ignoreCase)
+    {
+        std::vector<Key<T> > keys;
+        keys.reserve(metas.size());
+        for (T* meta : metas) {
+            if (ignoreCase) {
+                std::string foldedName = meta->jsName;
+                std::transform(foldedName.begin(), foldedName.end(), foldedName.begin(), ::tolower);
+                uint64_t prefix = prefixOf(foldedName);
+                keys.push_back({ prefix, std::move(foldedName), meta });
+            } else {
+                keys.push_back({ prefixOf(meta->jsName), std::string(), meta });
+            }
+        }
+
+        std::sort(keys.begin(), keys.end(), [ignoreCase](const Key<T>& a, const Key<T>& b) {
+            if (a.prefix != b.prefix) {
+                return a.prefix < b.prefix;
+            }
+            return ignoreCase ? a.foldedName < b.foldedName : a.meta->jsName < b.meta->jsName;
+        });
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            metas[i] = keys[i].meta;
+        }
+    }
+}
+
+/*
+ * \brief Sorts like std::sort with meta1->jsName < meta2->jsName.
+ */
+template <class T>
+static void sortByJsName(std::vector<T*>& metas)
+{
+    JsNameOrder::sortByKeys(metas, false);
+}
+
+/*
+ * \brief Sorts like std::sort comparing the lowercased jsNames.
+ */
+template <class T>
+static void sortByLowercaseJsName(std::vector<T*>& metas)
+{
+    JsNameOrder::sortByKeys(metas, true);
+}
+}
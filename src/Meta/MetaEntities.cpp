@@ -3,6 +3,7 @@
 #include <clang/Lex/HeaderSearch.h>
 #include <clang/Lex/Preprocessor.h>
 #include "Meta/Utils.h"
+#include "Utils/StringMatchers.h"
 #include "Utils/StringUtils.h"
 #include "TypeEntities.h"
 #include "MetaEntities.h"
@@ -155,35 +156,34 @@ string Meta::renamedName(string name, string ownerKey) {
   }
 
   string newName;
-  auto attribute = Type::attributesLookup[key]["renamed"];
+  auto attribute = Type::lookupAttributes(key)["renamed"];
 
   if (attribute != NULL) {
     newName = attribute.as<string>();
   }
-  else if (!Type::apiNotes[key].empty()) {
-    newName = Type::apiNotes[key];
+  else {
+    auto noteIt = Type::apiNotes.find(key);
+    if (noteIt != Type::apiNotes.end()) {
+      newName = noteIt->second;
+    }
   }
 
   if (newName.empty()) {
     return name;
   }
 
-  std::regex re("^Swift\\.");
-  newName = std::regex_replace(newName, re, "");
+  newName = StringMatchers::replacePrefix(newName, "Swift.", "");
 
   // Normalize selector style from:
   // nextEvent(matching:until:inMode:dequeue:)
   // to
   // nextEvent:matching:until:inMode:dequeue:
-  std::regex re1("\\(");
-  std::regex re2("\\)");
-  newName = std::regex_replace(newName, re1, ":");
-  newName = std::regex_replace(newName, re2, "");
+  newName = StringUtils::replaceString(newName, "(", ":");
+  newName = StringUtils::replaceString(newName, ")", "");
 
   // Use `create` instead of `init` for initializers,
   // since JSExport doesn't work on `init`
-  std::regex ire("^init:");
-  newName = std::regex_replace(newName, ire, "create:");
+  newName = StringMatchers::replacePrefix(newName, "init:", "create:");
   
   return newName;
 }
@@ -203,8 +203,7 @@ string Meta::jsConversionFnName(string paramName, const Type& type, const clang:
   string blockRetType = Type::formatType(type, qualType, true);
   bool isNullableBlockReturn = false;
   
-  regex nullableBlockReturn(".* _Nullable.*");
-  if (regex_match(qualType.getAsString(), nullableBlockReturn)) {
+  if (StringMatchers::lineContains(qualType.getAsString(), " _Nullable")) {
     isNullableBlockReturn = true;
   }
   
@@ -279,8 +278,7 @@ string Meta::getFunctionProtoCall(string paramName, const vector<Type*>& signatu
   
   bool isNullableBlockReturn = false;
   
-  regex nullableBlockReturn(".* _Nullable.*");
-  if (blockRetType != "Bool" && regex_match(qualType.getAsString(), nullableBlockReturn)) {
+  if (blockRetType != "Bool" && StringMatchers::lineContains(qualType.getAsString(), " _Nullable")) {
     isNullableBlockReturn = true;
   }
   
@@ -372,7 +370,7 @@ bool Meta::Meta::getUnavailableInSwift(::Meta::Meta* owner) {
   
   auto key = ownerKey + "." + this->name;
 
-  auto attributes = Type::attributesLookup[key];
+  const YAML::Node& attributes = Type::lookupAttributes(key);
   
   // attr lookups use the selector (this->name)
   if (attributes["deprecated"] != NULL) {
@@ -436,7 +434,9 @@ string Meta::Meta::dumpDeclComments() {
   string out;
   
   out += "\n  /**\n";
-  out += "    - Selector: " + this->name + "\n";
+  out += "    - Selector: ";
+  out += this->name;
+  out += "\n";
   
   //  return out;
   //
@@ -469,24 +469,34 @@ string Meta::Meta::dumpDeclComments() {
   vector<clang::AvailabilityAttr*> availabilityAttributes = Utils::getAttributes<clang::AvailabilityAttr>(*this->declaration);
   
   for (clang::AvailabilityAttr* availability : availabilityAttributes) {
-    if (availability->getPlatform()->getName().str() != string("macos")) {
+    if (availability->getPlatform()->getName() != "macos") {
       continue;
     }
     
     if (!availability->getIntroduced().empty()) {
-      out += "    - Introduced: " + MetaFactory::convertVersion(availability->getIntroduced()).to_string() + "\n";
+      out += "    - Introduced: ";
+      out += MetaFactory::convertVersion(availability->getIntroduced()).to_string();
+      out += "\n";
     }
     if (!availability->getDeprecated().empty()) {
-      out += "    - Deprecated: " + MetaFactory::convertVersion(availability->getDeprecated()).to_string() + "\n";
+      out += "    - Deprecated: ";
+      out += MetaFactory::convertVersion(availability->getDeprecated()).to_string();
+      out += "\n";
     }
     if (!availability->getObsoleted().empty()) {
-      out += "    - Obsoleted: " + MetaFactory::convertVersion(availability->getObsoleted()).to_string() + "\n";
+      out += "    - Obsoleted: ";
+      out += MetaFactory::convertVersion(availability->getObsoleted()).to_string();
+      out += "\n";
     }
     if (!availability->getReplacement().empty()) {
-      out += "    - Replacement: " + availability->getReplacement().str() + "\n";
+      out += "    - Replacement: ";
+      out.append(availability->getReplacement().data(), availability->getReplacement().size());
+      out += "\n";
     }
     if (!availability->getMessage().empty()) {
-      out += "    - Message: " + availability->getMessage().str() + "\n";
+      out += "    - Message: ";
+      out.append(availability->getMessage().data(), availability->getMessage().size());
+      out += "\n";
     }
     if (availability->getUnavailable()) {
       out += "    - Unavailable\n";
@@ -535,32 +545,44 @@ bool Meta::MethodMeta::hasTargetAction() {
   return false;
 }
 
-string Meta::MethodMeta::builtName() {
+void Meta::MethodMeta::decomposeSelector() {
+  selectorTokens.clear();
+  llvm::StringRef(this->name).split(selectorTokens, ':', -1, false);
+}
+
+const string& Meta::MethodMeta::builtName() {
+  call_once(_builtName.once, [this]() {
+    _builtName.name = buildName();
+  });
+  return _builtName.name;
+}
+
+string Meta::MethodMeta::buildName() {
   std::string output = "";
-  std::string selector = this->name;
-  std::vector<std::string> selectorTokens;
+  // Views of the labels, constructor tokens or selector parts the name is built from, nothing is split or copied here
+  std::vector<llvm::StringRef> selectorTokens;
   std::string prefix = "";
   
   if (this->name.substr(0, 4) != "init") {
     if (this->argLabels.size() && !(this->argLabels.size() == 1 && this->argLabels[0] == "_")) {
-      selectorTokens = this->argLabels;
+      selectorTokens.assign(this->argLabels.begin(), this->argLabels.end());
       if (!this->isInit()) {
         selectorTokens.insert(selectorTokens.begin(), this->jsName);
       }
     }
     else {
-      StringUtils::split(selector, ':', back_inserter(selectorTokens));
+      selectorTokens.assign(this->selectorTokens.begin(), this->selectorTokens.end());
     }
   }
   else if (this->constructorTokens.size()) {
-    selectorTokens = this->constructorTokens;
+    selectorTokens.assign(this->constructorTokens.begin(), this->constructorTokens.end());
   }
   else if (this->argLabels.size() && !(this->argLabels.size() == 1 && this->argLabels[0] == "_")) {
-    selectorTokens = this->argLabels;
+    selectorTokens.assign(this->argLabels.begin(), this->argLabels.end());
     selectorTokens.insert(selectorTokens.begin(), this->jsName);
   }
-  else if (selector.length()) {
-    StringUtils::split(selector, ':', back_inserter(selectorTokens));
+  else if (this->name.length()) {
+    selectorTokens.assign(this->selectorTokens.begin(), this->selectorTokens.end());
   }
 
   size_t numTokens = this->hasTargetAction() ? selectorTokens.size() - 2 : selectorTokens.size();
@@ -574,18 +596,15 @@ string Meta::MethodMeta::builtName() {
   size_t idx = 0;
   
   string moduleName = this->module->Name;
-  regex frameworkPrefixes("^(NS|AV|IK)");
-  string moduleNameNoPrefix = regex_replace(moduleName, frameworkPrefixes, "");
+  string moduleNameNoPrefix = StringMatchers::removeFrameworkPrefix(moduleName);
   size_t withOffset = 0;
-  regex cbPrefixes("CompletionHandler$");
-  regex createSep("With");
 
   if (numTokens > 1 && selectorTokens[0] == this->jsName) {
     withOffset = 1;
   }
   
   for (size_t i = 0; i < numTokens; i++) {
-    std::string token = selectorTokens[i];
+    std::string token = selectorTokens[i].str();
     if (token == "_") {
       continue;
     }
@@ -620,10 +639,10 @@ string Meta::MethodMeta::builtName() {
       token = "Callback";
     }
     
-    token = regex_replace(token, cbPrefixes, "Callback");
+    token = StringMatchers::replaceSuffix(token, "CompletionHandler", "Callback");
 
     if (this->isInit()) {
-      token = regex_replace(token, createSep, "_");
+      token = StringUtils::replaceString(token, "With", "_");
     }
     
     output += token;
@@ -649,8 +668,7 @@ string Meta::MethodMeta::builtName() {
   
   output[0] = tolower(output[0]);
   
-  std::regex re("^initWith");
-  output = std::regex_replace(output, re, "createWith");
+  output = StringMatchers::replacePrefix(output, "initWith", "createWith");
 
   return output;
 }
@@ -691,13 +709,12 @@ string Meta::MethodMeta::getTypeNullability(BaseClassMeta* owner) {
 string Meta::MethodMeta::getTypeNullability(clang::ParmVarDecl* decl) {
   ostringstream output;
   auto attrs = decl->getAttrs();
-  regex nullableRegex(".* _Nullable$");
   string typeString = decl->getType().getAsString();
   string declName = decl->getNameAsString();
   
   //  cout << declName << " - " << typeString << endl;
   
-  if (regex_match(typeString, nullableRegex)) {
+  if (StringMatchers::lineEndsWith(typeString, " _Nullable")) {
     // in rare cases this is needed - like tabGroup in NSWindow - not sure why
     // in theory these should show up in the attrs
     output << "?";
@@ -946,7 +963,6 @@ string Meta::PropertyMeta::getNullabilitySymbol(BaseClassMeta* owner) {
   
   auto decl = clang::dyn_cast<clang::ObjCPropertyDecl>(this->declaration);
   auto attrs = decl->getPropertyAttributes();
-  regex nullableRegex(".* _Nullable$");
   
   if (decl->isOptional()) {
     output << "?";
@@ -961,7 +977,7 @@ string Meta::PropertyMeta::getNullabilitySymbol(BaseClassMeta* owner) {
   else if (owner->is(MetaType::Protocol) && clang::dyn_cast<clang::ObjCPropertyDecl>(decl)->getPropertyImplementation() == clang::ObjCPropertyDecl::PropertyControl::Optional) {
     output << "?";
   }
-  else if (regex_match(decl->getType().getAsString(), nullableRegex)) {
+  else if (StringMatchers::lineEndsWith(decl->getType().getAsString(), " _Nullable")) {
     // in rare cases this is needed - like tabGroup in NSWindow - not sure why
     // in theory these should show up in the attrs
     output << "?";
@@ -3,18 +3,22 @@
 #include "MetaVisitor.h"
 #include "TypeEntities.h"
 #include "Utils/Noncopyable.h"
+#include "Utils/StringMatchers.h"
 #include "Utils/StringUtils.h"
 #include <clang/Basic/Module.h>
 #include <clang/AST/DeclBase.h>
 #include <clang/AST/DeclObjC.h>
 #include <iostream>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
 #include <llvm/ADT/iterator_range.h>
 #include <map>
+#include <mutex>
+#include <new>
 #include <unordered_set>
 #include <string>
 #include <unordered_map>
 #include <vector>
-#include <regex>
 
 #define UNKNOWN_VERSION \
     {                   \
@@ -253,8 +257,7 @@ public:
       if (this->jsName == "IKImageView") {
         return this->jsName;
       }
-      std::regex frameworkPrefixes("^(NS|AV|IK)");
-      return regex_replace(this->jsName, frameworkPrefixes, "");
+      return StringMatchers::removeFrameworkPrefix(this->jsName);
     }
   
     std::string kebabCase(std::string camelCase) const {
@@ -274,15 +277,13 @@ public:
 
     std::string kebabName() const
     {
-      std::regex re1("^(NS|AV|IK)");
-      std::string noPrefix = this->kebabCase(std::regex_replace(this->jsName, re1, ""));
+      std::string noPrefix = this->kebabCase(StringMatchers::removeFrameworkPrefix(this->jsName));
       
       if (noPrefix == "text-view") {
         return noPrefix;
       }
       
-      std::regex re2("-view$");
-      std::string noSuffix = std::regex_replace(noPrefix, re2, "");
+      std::string noSuffix = StringMatchers::replaceSuffix(noPrefix, "-view", "");
       
       return noSuffix;
     }
@@ -312,16 +313,42 @@ public:
   
   // Get the replacement selector name from api notes and attrs
   std::string getReplacement();
-  std::string builtName();
+  // Built once on the first call, which happens in the writers after the filters have settled the names
+  const std::string& builtName();
   std::string getParamsAsString(BaseClassMeta* owner, ParamCallType callType = ParamCallType::Definition);
   std::string getTypeNullability(clang::ParmVarDecl* decl);
   std::string getTypeNullability(BaseClassMeta* owner);
   bool hasTargetAction();
 
+  // Splits the selector, called once the meta factory has set name
+  void decomposeSelector();
+
   std::vector<Type*> signature;
   std::vector<std::string> constructorTokens;
+  // The non-empty parts of the selector between the colons, referring to name
+  llvm::SmallVector<llvm::StringRef, 4> selectorTokens;
 
   virtual void visit(MetaVisitor* visitor) override;
+
+private:
+  std::string buildName();
+
+  // Assigning a meta over this one, like the meta factory does to reset it, clears the name so it is built again
+  struct BuiltNameCache {
+    std::once_flag once;
+    std::string name;
+    
+    BuiltNameCache() = default;
+    BuiltNameCache(const BuiltNameCache&) {}
+    BuiltNameCache& operator=(const BuiltNameCache&) {
+      name.clear();
+      once.~once_flag();
+      new (&once) std::once_flag();
+      return *this;
+    }
+  };
+  
+  BuiltNameCache _builtName;
 };
 
 class PropertyMeta : public Meta {
@@ -1,8 +1,10 @@
 #include "MetaFactory.h"
 #include "MetaEntities.h"
 #include "CreationException.h"
+#include "JsNameOrder.h"
 #include "JSExport/JSExportDefinitionWriter.h"
 #include "Utils.h"
+#include "Utils/StringMatchers.h"
 #include "Utils/StringUtils.h"
 #include "ValidateMetaTypeVisitor.h"
 #include <iostream>
@@ -15,25 +17,11 @@ using namespace std;
 
 namespace Meta {
 
-static bool compareJsNames(string& protocol1, string& protocol2)
-{
-  string name1 = protocol1;
-  string name2 = protocol2;
-  transform(name1.begin(), name1.end(), name1.begin(), ::tolower);
-  transform(name2.begin(), name2.end(), name2.begin(), ::tolower);
-  return name1 < name2;
-}
-
-static bool metasComparerByJsName(Meta* meta1, Meta* meta2)
-{
-  return compareJsNames(meta1->jsName, meta2->jsName);
-}
-
 void MetaFactory::validate(Type* type)
 {
   ValidateMetaTypeVisitor validator(*this);
   
-  type->visit(validator);
+  type->dispatch(validator);
 }
 
 void MetaFactory::validate(Meta* meta)
@@ -424,8 +412,7 @@ void MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMe
     assert(methodMeta.getSelector().find("init", 0) == 0);
     
     // For JSExport bridging, we s/init/create since it does not support 'init' keyword
-    regex re("^init");
-    methodMeta.jsName = regex_replace(methodMeta.jsName, re, "create");
+    methodMeta.jsName = StringMatchers::replacePrefix(methodMeta.jsName, "init", "create");
 
     string initPrefix = methodMeta.getSelector().find("initWith", 0) == 0 ? "initWith" : "init";
     string selector = methodMeta.getSelector().substr(initPrefix.length(), string::npos);
@@ -457,23 +444,19 @@ void MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMe
         
         if (token.size() >= 4 && token.substr(token.size() - 3, 3) == "url") {
           // *url -> *URL
-          regex re("(\\w+)url$");
-          token = regex_replace(token, re, "$1URL");
+          token = StringMatchers::replaceWordSuffix(token, "url", "URL");
         }
         else if (token.size() >= 3 && token.substr(token.size() - 2, 2) == "id") {
           // *id -> *ID
-          regex re("(\\w+)id$");
-          token = regex_replace(token, re, "$1ID");
+          token = StringMatchers::replaceWordSuffix(token, "id", "ID");
         }
         else if (token.size() >= 10 && token.substr(token.size() - 9, 9) == "WithTests") {
           // *WithTests -> *With
-          regex re("(\\w+)WithTests$");
-          token = regex_replace(token, re, "$1With");
+          token = StringMatchers::replaceWordSuffix(token, "WithTests", "With");
         }
         else if (token.size() >= 9 && token.substr(token.size() - 8, 8) == "WithTest") {
           // *WithTest -> *With
-          regex re("(\\w+)WithTest$");
-          token = regex_replace(token, re, "$1With");
+          token = StringMatchers::replaceWordSuffix(token, "WithTest", "With");
         }
 
         if (token.size() >= 5 && token.substr(0, 4) == "objc") {
@@ -500,10 +483,7 @@ void MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMe
           }
         }
         
-        ostringstream joinedTokens;
-        const char* delimiter = ":";
-        copy(ctorTokens.begin(), ctorTokens.end(), ostream_iterator<string>(joinedTokens, delimiter));
-        methodMeta.constructorTokens = ctorTokens;
+        methodMeta.constructorTokens = move(ctorTokens);
       }
     }
   }
@@ -541,6 +521,8 @@ void MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMe
   bool returnsSelf = isInitializer || methodMeta.signature[0]->is(TypeInstancetype);
   
   methodMeta.setFlags(MetaFlags::MethodReturnsSelf, returnsSelf);
+  
+  methodMeta.decomposeSelector();
 }
 
 void MetaFactory::createFromProperty(const clang::ObjCPropertyDecl& property, PropertyMeta& propertyMeta)
@@ -584,21 +566,21 @@ string demangleSwiftName(string name) {
   return result;
 }
 
-vector<string> selectorParts(string selector) {
+vector<string> selectorParts(llvm::StringRef selector) {
   vector<string> parts;
   
-  if (selector == "") { return parts; }
+  llvm::SmallVector<llvm::StringRef, 2> outerTokens;
+  llvm::SmallVector<llvm::StringRef, 8> innerTokens;
   
-  vector<string> outerTokens;
-  vector<string> innerTokens;
+  selector.split(outerTokens, '(', -1, false);
   
-  StringUtils::split(selector, '(', back_inserter(outerTokens));
+  if (outerTokens.empty()) { return parts; }
   
-  string rest;
+  llvm::StringRef rest;
   
   if (outerTokens.size() > 1) {
     // insertItem(withObjectValue:at:) -> ["insertItem", "withObjectValue", "at"]
-    parts.push_back(outerTokens[0]);
+    parts.push_back(outerTokens[0].str());
     rest = outerTokens[1];
   }
   else {
@@ -606,11 +588,11 @@ vector<string> selectorParts(string selector) {
     rest = outerTokens[0];
   }
   
-  StringUtils::split(rest, ':', back_inserter(innerTokens));
+  rest.split(innerTokens, ':', -1, false);
   
-  for (auto innerToken: innerTokens) {
+  for (llvm::StringRef innerToken : innerTokens) {
     if (innerToken != ")") {
-      parts.push_back(innerToken);
+      parts.push_back(innerToken.str());
     }
   }
   
@@ -802,7 +784,7 @@ void MetaFactory::populateBaseClassMetaFields(const clang::ObjCContainerDecl& de
       baseClass.protocols.push_back(&protocolMeta->as<ProtocolMeta>());
     }
   }
-  sort(baseClass.protocols.begin(), baseClass.protocols.end(), metasComparerByJsName); // order by jsName
+  sortByLowercaseJsName(baseClass.protocols); // order by jsName, ignoring case
   
   for (clang::ObjCMethodDecl* classMethod : decl.class_methods()) {
     Meta* methodMeta;
@@ -814,7 +796,7 @@ void MetaFactory::populateBaseClassMetaFields(const clang::ObjCContainerDecl& de
     }
   }
   
-  sort(baseClass.staticMethods.begin(), baseClass.staticMethods.end(), metasComparerByJsName); // order by jsName
+  sortByLowercaseJsName(baseClass.staticMethods); // order by jsName, ignoring case
   
   for (clang::ObjCMethodDecl* instanceMethod : decl.instance_methods()) {
     Meta* methodMeta;
@@ -825,7 +807,7 @@ void MetaFactory::populateBaseClassMetaFields(const clang::ObjCContainerDecl& de
       baseClass.instanceMethods.push_back(&methodMeta->as<MethodMeta>());
     }
   }
-  sort(baseClass.instanceMethods.begin(), baseClass.instanceMethods.end(), metasComparerByJsName); // order by jsName
+  sortByLowercaseJsName(baseClass.instanceMethods); // order by jsName, ignoring case
   
   for (clang::ObjCPropertyDecl* property : decl.properties()) {
     Meta* propertyMeta;
@@ -840,8 +822,8 @@ void MetaFactory::populateBaseClassMetaFields(const clang::ObjCContainerDecl& de
       }
     }
   }
-  sort(baseClass.instanceProperties.begin(), baseClass.instanceProperties.end(), metasComparerByJsName); // order by jsName
-  sort(baseClass.staticProperties.begin(), baseClass.staticProperties.end(), metasComparerByJsName); // order by jsName
+  sortByLowercaseJsName(baseClass.instanceProperties); // order by jsName, ignoring case
+  sortByLowercaseJsName(baseClass.staticProperties); // order by jsName, ignoring case
 }
 
 string MetaFactory::renameMeta(MetaType type, string& originalJsName, int index)
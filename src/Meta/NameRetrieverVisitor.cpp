@@ -8,184 +8,192 @@
 #include "NameRetrieverVisitor.h"
 #include "MetaEntities.h"
 
-#include <sstream>
+#include <mutex>
 
 using namespace std;
 
 NameRetrieverVisitor NameRetrieverVisitor::instanceObjC(false);
 NameRetrieverVisitor NameRetrieverVisitor::instanceTs(true);
 
-string NameRetrieverVisitor::visitVoid() {
+llvm::StringRef NameRetrieverVisitor::visitVoid() {
     return "void";
 }
     
-string NameRetrieverVisitor::visitBool() {
+llvm::StringRef NameRetrieverVisitor::visitBool() {
     return this->tsNames ? "boolean" : "bool";
 }
     
-string NameRetrieverVisitor::visitShort() {
+llvm::StringRef NameRetrieverVisitor::visitShort() {
     return this->tsNames ? "number" : "short";
 }
 
-string NameRetrieverVisitor::visitUShort() {
+llvm::StringRef NameRetrieverVisitor::visitUShort() {
     return this->tsNames ? "number" : "unsigned short";
 }
     
-string NameRetrieverVisitor::visitInt() {
+llvm::StringRef NameRetrieverVisitor::visitInt() {
     return this->tsNames ? "number" : "int";
 }
     
-string NameRetrieverVisitor::visitUInt() {
+llvm::StringRef NameRetrieverVisitor::visitUInt() {
     return this->tsNames ? "number" : "unsigned int";
 }
     
-string NameRetrieverVisitor::visitLong() {
+llvm::StringRef NameRetrieverVisitor::visitLong() {
     return this->tsNames ? "number" : "long";
 }
     
-string NameRetrieverVisitor::visitUlong() {
+llvm::StringRef NameRetrieverVisitor::visitUlong() {
     return this->tsNames ? "number" : "unsigned long";
 }
     
-string NameRetrieverVisitor::visitLongLong() {
+llvm::StringRef NameRetrieverVisitor::visitLongLong() {
     return this->tsNames ? "number" : "long long";
 }
     
-string NameRetrieverVisitor::visitULongLong() {
+llvm::StringRef NameRetrieverVisitor::visitULongLong() {
     return this->tsNames ? "number" : "unsigned long long";
 }
     
-string NameRetrieverVisitor::visitSignedChar() {
+llvm::StringRef NameRetrieverVisitor::visitSignedChar() {
     return this->tsNames ? "number" : "signed char";
 }
     
-string NameRetrieverVisitor::visitUnsignedChar() {
+llvm::StringRef NameRetrieverVisitor::visitUnsignedChar() {
     return this->tsNames ? "number" : "unsigned char";
 }
     
-string NameRetrieverVisitor::visitUnichar() {
+llvm::StringRef NameRetrieverVisitor::visitUnichar() {
     return this->tsNames ? "number" : "wchar_t";
 }
     
-string NameRetrieverVisitor::visitCString() {
+llvm::StringRef NameRetrieverVisitor::visitCString() {
     return this->tsNames ? "string" : "char*";
 }
     
-string NameRetrieverVisitor::visitFloat() {
+llvm::StringRef NameRetrieverVisitor::visitFloat() {
     return this->tsNames ? "number" : "float";
 }
     
-string NameRetrieverVisitor::visitDouble() {
+llvm::StringRef NameRetrieverVisitor::visitDouble() {
     return this->tsNames ? "number" : "double";
 }
     
-string NameRetrieverVisitor::visitVaList() {
+llvm::StringRef NameRetrieverVisitor::visitVaList() {
     return "";
 }
     
-string NameRetrieverVisitor::visitSelector() {
+llvm::StringRef NameRetrieverVisitor::visitSelector() {
     return this->tsNames ? "string" : "SEL";
 }
     
-string NameRetrieverVisitor::visitInstancetype() {
+llvm::StringRef NameRetrieverVisitor::visitInstancetype() {
     return this->tsNames ? "any" : "instancetype";
 }
     
-string NameRetrieverVisitor::visitClass(const ClassType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitClass(const ClassType& typeDetails) {
     return this->tsNames ? "any" : "Class";
 }
     
-string NameRetrieverVisitor::visitProtocol() {
+llvm::StringRef NameRetrieverVisitor::visitProtocol() {
     return this->tsNames ? "any" : "Protocol";
 }
     
-string NameRetrieverVisitor::visitId(const IdType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitId(const IdType& typeDetails) {
     return this->tsNames ? "any" : "id";
 }
     
-string NameRetrieverVisitor::visitConstantArray(const ConstantArrayType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitConstantArray(const ConstantArrayType& typeDetails) {
     return this->generateFixedArray(typeDetails.innerType, typeDetails.size);
 }
     
-string NameRetrieverVisitor::visitExtVector(const ExtVectorType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitExtVector(const ExtVectorType& typeDetails) {
     return this->generateFixedArray(typeDetails.innerType, typeDetails.size);
 }
 
-string NameRetrieverVisitor::visitIncompleteArray(const IncompleteArrayType& typeDetails) {
-    return typeDetails.innerType->visit(*this).append("[]");
+llvm::StringRef NameRetrieverVisitor::visitIncompleteArray(const IncompleteArrayType& typeDetails) {
+    return this->intern(typeDetails.innerType->dispatch(*this).str() + "[]");
 }
     
-string NameRetrieverVisitor::visitInterface(const InterfaceType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitInterface(const InterfaceType& typeDetails) {
     return this->tsNames ? typeDetails.interface->jsName : typeDetails.interface->name;
 }
     
-string NameRetrieverVisitor::visitBridgedInterface(const BridgedInterfaceType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitBridgedInterface(const BridgedInterfaceType& typeDetails) {
     return typeDetails.name;
 }
     
-string NameRetrieverVisitor::visitPointer(const PointerType& typeDetails) {
-    return this->tsNames ? "any" : typeDetails.innerType->visit(*this).append("*");
+llvm::StringRef NameRetrieverVisitor::visitPointer(const PointerType& typeDetails) {
+    if (this->tsNames) {
+        return "any";
+    }
+    return this->intern(typeDetails.innerType->dispatch(*this).str() + "*");
 }
     
-string NameRetrieverVisitor::visitBlock(const BlockType& typeDetails) {
-    return this->tsNames ? this->getFunctionTypeScriptName(typeDetails.signature) : "void*" /*TODO: construct objective-c full block definition*/;
+llvm::StringRef NameRetrieverVisitor::visitBlock(const BlockType& typeDetails) {
+    return this->tsNames ? this->getFunctionTypeScriptName(typeDetails.signature) : llvm::StringRef("void*") /*TODO: construct objective-c full block definition*/;
 }
 
-string NameRetrieverVisitor::visitFunctionPointer(const FunctionPointerType& typeDetails) {
-    return this->tsNames ? this->getFunctionTypeScriptName(typeDetails.signature) : "void*"/*TODO: construct objective-c full function pointer definition*/;
+llvm::StringRef NameRetrieverVisitor::visitFunctionPointer(const FunctionPointerType& typeDetails) {
+    return this->tsNames ? this->getFunctionTypeScriptName(typeDetails.signature) : llvm::StringRef("void*")/*TODO: construct objective-c full function pointer definition*/;
 }
 
-string NameRetrieverVisitor::visitStruct(const StructType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitStruct(const StructType& typeDetails) {
     return this->tsNames ? typeDetails.structMeta->jsName : typeDetails.structMeta->name;
 }
     
-string NameRetrieverVisitor::visitUnion(const UnionType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitUnion(const UnionType& typeDetails) {
     return this->tsNames ? typeDetails.unionMeta->jsName : typeDetails.unionMeta->name;
 }
     
-string NameRetrieverVisitor::visitAnonymousStruct(const AnonymousStructType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitAnonymousStruct(const AnonymousStructType& typeDetails) {
     return "";
 }
     
-string NameRetrieverVisitor::visitAnonymousUnion(const AnonymousUnionType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitAnonymousUnion(const AnonymousUnionType& typeDetails) {
     return "";
 }
     
-string NameRetrieverVisitor::visitEnum(const EnumType& typeDetails) {
+llvm::StringRef NameRetrieverVisitor::visitEnum(const EnumType& typeDetails) {
     return this->tsNames ? typeDetails.enumMeta->jsName : typeDetails.enumMeta->name;
 }
     
-string NameRetrieverVisitor::visitTypeArgument(const ::Meta::TypeArgumentType& type) {
+llvm::StringRef NameRetrieverVisitor::visitTypeArgument(const ::Meta::TypeArgumentType& type) {
     return type.name;
 }
 
-string NameRetrieverVisitor::generateFixedArray(const Type *el_type, size_t size) {
-    stringstream ss(el_type->visit(*this));
-    ss << "[";
+llvm::StringRef NameRetrieverVisitor::generateFixedArray(const Type *el_type, size_t size) {
+    string name = el_type->dispatch(*this).str();
+    name += "[";
     if (!this->tsNames) {
-        ss << size;
+        name += to_string(size);
     }
-    ss << "]";
+    name += "]";
     
-    return ss.str();
+    return this->intern(name);
 }
 
-string NameRetrieverVisitor::getFunctionTypeScriptName(const vector<Type*> &signature) {
+llvm::StringRef NameRetrieverVisitor::getFunctionTypeScriptName(const vector<Type*> &signature) {
     // (p1: t1,...) => ret_type
     assert(signature.size() > 0);
     
-    stringstream ss;
-    ss << "(";
+    string name = "(";
     for (size_t i = 1; i < signature.size(); i++) {
         if (i > 1) {
-            ss << ", ";
+            name += ", ";
         }
-        ss << "p" << i << ": " << signature[i]->visit(*this);
+        name += "p" + to_string(i) + ": ";
+        name += signature[i]->dispatch(*this).str();
     }
-    ss << ")";
-    ss << " => ";
-    ss << signature[0]->visit(*this);
+    name += ")";
+    name += " => ";
+    name += signature[0]->dispatch(*this).str();
     
-    return ss.str();
+    return this->intern(name);
+}
+
+llvm::StringRef NameRetrieverVisitor::intern(const string& name) {
+    lock_guard<mutex> lock(_namesMutex);
+    return _names.insert(name).first->getKey();
 }
 
@@ -9,97 +9,110 @@
 #define NameRetrieverVisitor_h
 
 #include "TypeEntities.h"
-#include "TypeVisitor.h"
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/StringSet.h>
+#include <mutex>
 #include <string>
 
 using namespace Meta;
 
-class NameRetrieverVisitor : public ::Meta::TypeVisitor<std::string> {
+/*
+ * \class NameRetrieverVisitor
+ * \brief The ObjC or TypeScript name of a type, visited with \c Type::dispatch.
+ *
+ * Names are literals or the names of metas, and the ones put together for arrays, pointers and
+ * functions are interned by the visitor, so they stay valid as long as the visitor.
+ */
+class NameRetrieverVisitor final {
     
 public:
     static NameRetrieverVisitor instanceObjC;
     static NameRetrieverVisitor instanceTs;
 
-    virtual std::string visitVoid();
+    llvm::StringRef visitVoid();
     
-    virtual std::string visitBool();
+    llvm::StringRef visitBool();
     
-    virtual std::string visitShort();
+    llvm::StringRef visitShort();
     
-    virtual std::string visitUShort();
+    llvm::StringRef visitUShort();
     
-    virtual std::string visitInt();
+    llvm::StringRef visitInt();
     
-    virtual std::string visitUInt();
+    llvm::StringRef visitUInt();
     
-    virtual std::string visitLong();
+    llvm::StringRef visitLong();
     
-    virtual std::string visitUlong();
+    llvm::StringRef visitUlong();
     
-    virtual std::string visitLongLong();
+    llvm::StringRef visitLongLong();
     
-    virtual std::string visitULongLong();
+    llvm::StringRef visitULongLong();
     
-    virtual std::string visitSignedChar();
+    llvm::StringRef visitSignedChar();
     
-    virtual std::string visitUnsignedChar();
+    llvm::StringRef visitUnsignedChar();
     
-    virtual std::string visitUnichar();
+    llvm::StringRef visitUnichar();
     
-    virtual std::string visitCString();
+    llvm::StringRef visitCString();
     
-    virtual std::string visitFloat();
+    llvm::StringRef visitFloat();
     
-    virtual std::string visitDouble();
+    llvm::StringRef visitDouble();
     
-    virtual std::string visitVaList();
+    llvm::StringRef visitVaList();
     
-    virtual std::string visitSelector();
+    llvm::StringRef visitSelector();
     
-    virtual std::string visitInstancetype();
+    llvm::StringRef visitInstancetype();
     
-    virtual std::string visitClass(const ClassType& typeDetails);
+    llvm::StringRef visitClass(const ClassType& typeDetails);
     
-    virtual std::string visitProtocol();
+    llvm::StringRef visitProtocol();
     
-    virtual std::string visitId(const IdType& typeDetails);
+    llvm::StringRef visitId(const IdType& typeDetails);
     
-    virtual std::string visitConstantArray(const ConstantArrayType& typeDetails);
+    llvm::StringRef visitConstantArray(const ConstantArrayType& typeDetails);
     
-    virtual std::string visitExtVector(const ExtVectorType& typeDetails);
+    llvm::StringRef visitExtVector(const ExtVectorType& typeDetails);
     
-    virtual std::string visitIncompleteArray(const IncompleteArrayType& typeDetails);
+    llvm::StringRef visitIncompleteArray(const IncompleteArrayType& typeDetails);
     
-    virtual std::string visitInterface(const InterfaceType& typeDetails);
+    llvm::StringRef visitInterface(const InterfaceType& typeDetails);
     
-    virtual std::string visitBridgedInterface(const BridgedInterfaceType& typeDetails);
+    llvm::StringRef visitBridgedInterface(const BridgedInterfaceType& typeDetails);
     
-    virtual std::string visitPointer(const PointerType& typeDetails);
+    llvm::StringRef visitPointer(const PointerType& typeDetails);
     
-    virtual std::string visitBlock(const BlockType& typeDetails);
+    llvm::StringRef visitBlock(const BlockType& typeDetails);
     
-    virtual std::string visitFunctionPointer(const FunctionPointerType& typeDetails);
+    llvm::StringRef visitFunctionPointer(const FunctionPointerType& typeDetails);
     
-    virtual std::string visitStruct(const StructType& typeDetails);
+    llvm::StringRef visitStruct(const StructType& typeDetails);
     
-    virtual std::string visitUnion(const UnionType& typeDetails);
+    llvm::StringRef visitUnion(const UnionType& typeDetails);
     
-    virtual std::string visitAnonymousStruct(const AnonymousStructType& typeDetails);
+    llvm::StringRef visitAnonymousStruct(const AnonymousStructType& typeDetails);
     
-    virtual std::string visitAnonymousUnion(const AnonymousUnionType& typeDetails);
+    llvm::StringRef visitAnonymousUnion(const AnonymousUnionType& typeDetails);
     
-    virtual std::string visitEnum(const EnumType& typeDetails);
+    llvm::StringRef visitEnum(const EnumType& typeDetails);
     
-    virtual std::string visitTypeArgument(const ::Meta::TypeArgumentType& type);
+    llvm::StringRef visitTypeArgument(const ::Meta::TypeArgumentType& type);
 
 private:
     NameRetrieverVisitor(bool tsNames): tsNames(tsNames) { }
 
-    std::string getFunctionTypeScriptName(const std::vector<Type*> &signature);
-    std::string generateFixedArray(const Type *el_type, size_t size);
+    llvm::StringRef getFunctionTypeScriptName(const std::vector<Type*> &signature);
+    llvm::StringRef generateFixedArray(const Type *el_type, size_t size);
+    llvm::StringRef intern(const std::string& name);
 
 private:
     bool tsNames;
+    // Shared by the writers of all modules
+    std::mutex _namesMutex;
+    llvm::StringSet<> _names;
 };
 
 #endif /* NameRetrieverVisitor_h */
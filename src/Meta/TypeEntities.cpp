@@ -1,12 +1,14 @@
 #include "TypeEntities.h"
 #include "MetaEntities.h"
 #include "JSExport/JSExportDefinitionWriter.h"
-#include <regex>
+#include "TypeFormatCache.h"
+#include "Utils/StaticNameTable.h"
+#include "Utils/StringMatchers.h"
 
 using namespace std;
 
 namespace Meta {
-static map<string, string> bridgeNames = {
+static constexpr auto bridgeNames = StaticNameTable::makeMap({
   { "float", "CGFloat" },
   { "NSString", "String" },
   { "SEL", "String" },
@@ -31,19 +33,29 @@ static map<string, string> bridgeNames = {
   { "NSConnection", "NSXPCConnection" },
   { "NSUnitInformationStorage", "UnitInformationStorage" },
   { "NSStringEncoding", "UInt" }
-};
+});
 
 map<string, string> Type::apiNotes = {};
 map<string, YAML::Node> Type::attributesLookup = {};
 
+// The lookups below don't insert missing keys, the tables are read by writers running in parallel
+
 string Type::lookupApiNotes(string type) {
-  if (!apiNotes[type].empty()) {
-    return apiNotes[type];
+  auto noteIt = apiNotes.find(type);
+  if (noteIt != apiNotes.end() && !noteIt->second.empty()) {
+    return noteIt->second;
   }
   
   return type;
 }
 
+const YAML::Node& Type::lookupAttributes(const string& key) {
+  // Created as a map up front, so indexing it doesn't have to lazily create its node
+  static const YAML::Node noAttributes(YAML::NodeType::Map);
+  auto attributesIt = attributesLookup.find(key);
+  return attributesIt != attributesLookup.end() ? attributesIt->second : noAttributes;
+}
+
 string sdkVersion = getenv("SDKVERSION");
 string sdkRoot = "/Library/Developer/CommandLineTools/SDKs/MacOSX" + sdkVersion + ".sdk";
 string dataRoot = getenv("DATAPATH");
@@ -153,8 +165,9 @@ bool Type::populateModuleAttrs(string moduleName)
 
 string Type::nameForJSExport(const string& jsName) 
 {
-  if (!bridgeNames[jsName].empty()) {
-    return bridgeNames[jsName];
+  llvm::StringRef bridgeName = bridgeNames.lookup(jsName);
+  if (!bridgeName.empty()) {
+    return bridgeName.str();
   }
   
   return jsName;
@@ -186,8 +199,10 @@ string Type::formatTypeAnonymous(const Type& type, const clang::QualType pointer
 }
 
 void Type::stripModifiersFromPointerType(string& name) {
-  std::regex re("^NSObject<(\\w+)>$");
-  name = std::regex_replace(name, re, "$1");
+  string protocolName = StringMatchers::genericArgument(name, "NSObject");
+  if (!protocolName.empty()) {
+    name = protocolName;
+  }
   
   findAndReplaceIn(name, "__kindof ", "");
   findAndReplaceIn(name, "const ", "");
@@ -260,8 +275,7 @@ string Type::formatTypePointer(const PointerType& pointerType, const clang::Qual
   bool isPointerClassName = false;
   auto typePtr = pointerQualType.getTypePtrOrNull();
   
-  regex pointerClassName(".*Pointer$");
-  if (regex_match(name, pointerClassName)) {
+  if (StringMatchers::lineEndsWith(name, "Pointer")) {
     isPointerClassName = true;
   }
   
@@ -272,10 +286,9 @@ string Type::formatTypePointer(const PointerType& pointerType, const clang::Qual
       unsafeType += "UnsafePointer";
     }
     else {
-      regex autoreleasingRe("^\\w+<\\w+,id>$");
       string nullableSuffix = " _Nullable * _Nullable";
       
-      if (regex_match(name, autoreleasingRe)) {
+      if (StringMatchers::isGenericWithIdValue(name)) {
         out += "Autoreleasing";
       }
       else if (StringUtils::ends_with(pointerQualTypeName, nullableSuffix)) {
@@ -323,8 +336,7 @@ string Type::formatTypePointer(const PointerType& pointerType, const clang::Qual
     out += nameForJSExport(renamedName(name));
   }
   
-  regex nullableRegex(".* _Nullable$");
-  if (regex_match(typePtr->getPointeeType().getAsString(), nullableRegex)) {
+  if (StringMatchers::lineEndsWith(typePtr->getPointeeType().getAsString(), " _Nullable")) {
     isInnerNullable = true;
   }
   
@@ -476,6 +488,13 @@ string Type::formatTypeInterface(const Type& type, const clang::QualType pointer
 }
 
 string Type::formatType(const Type& type, const clang::QualType pointerType, const bool ignorePointerType)
+{
+  return TypeFormatCache::format(TypeFormatCache::Spelling::Swift, type, pointerType.getAsOpaquePtr(), ignorePointerType ? TypeFormatCache::IgnorePointerType : 0, [&]() {
+    return formatTypeUncached(type, pointerType, ignorePointerType);
+  });
+}
+
+string Type::formatTypeUncached(const Type& type, const clang::QualType pointerType, const bool ignorePointerType)
 {
   string typeStr = "";
   string pointerTypeStr = pointerType.getAsString();
@@ -586,8 +605,10 @@ string Type::formatType(const Type& type, const clang::QualType pointerType, con
       auto pointeeType = pointerType->getPointeeType();
       string pointeeTypeStr = pointeeType.getAsString();
       stripModifiersFromPointerType(pointeeTypeStr);
-      regex re("^\\w+<(\\w+)>$");
-      string pointeeTypeInnerStr = regex_replace(pointeeTypeStr, re, "$1");
+      string pointeeTypeInnerStr = StringMatchers::genericArgument(pointeeTypeStr);
+      if (pointeeTypeInnerStr.empty()) {
+        pointeeTypeInnerStr = pointeeTypeStr;
+      }
       
       if (pointeeTypeStr == "Class" || pointeeTypeInnerStr == "Class") {
         return "AnyClass";
@@ -656,7 +677,7 @@ string Type::writeFunctionProto(const vector<Type*>& signature)
   for (size_t i = 1; i < signature.size(); i++) {
     string retType = tsifyType(*signature[i]);
 
-    bool isProtoClass = TypeScript::JSExportDefinitionWriter::overlaidClasses.find(retType) != TypeScript::JSExportDefinitionWriter::overlaidClasses.end();
+    bool isProtoClass = TypeScript::JSExportDefinitionWriter::isOverlaidClass(retType);
     
     // swift overlay classes
     if (isProtoClass) {
@@ -675,6 +696,14 @@ string Type::writeFunctionProto(const vector<Type*>& signature)
 }
 
 string Type::tsifyType(const Type& type, const bool isFuncParam, const bool forComponent)
+{
+  unsigned flags = (isFuncParam ? TypeFormatCache::IsFuncParam : 0) | (forComponent ? TypeFormatCache::ForComponent : 0);
+  return TypeFormatCache::format(TypeFormatCache::Spelling::TypeScript, type, nullptr, flags, [&]() {
+    return tsifyTypeUncached(type, isFuncParam, forComponent);
+  });
+}
+
+string Type::tsifyTypeUncached(const Type& type, const bool isFuncParam, const bool forComponent)
 {
   string typeStr;
   string enumModuleName;
@@ -708,7 +737,7 @@ string Type::tsifyType(const Type& type, const bool isFuncParam, const bool forC
       string res = "string";
       if (isFuncParam) {
         Type typeVoid(TypeVoid);
-        res += " | " + Type::nameForJSExport(Type::lookupApiNotes(tsifyType(::Meta::PointerType(&typeVoid), isFuncParam)));
+        res += " | " + Type::nameForJSExport(Type::lookupApiNotes(tsifyTypeUncached(::Meta::PointerType(&typeVoid), isFuncParam)));
       }
       typeStr = res;
       break;
@@ -748,7 +777,7 @@ string Type::tsifyType(const Type& type, const bool isFuncParam, const bool forC
     case TypeInterface:
     case TypeBridgedInterface: {
       if (type.is(TypeType::TypeBridgedInterface) && type.as<BridgedInterfaceType>().isId()) {
-        typeStr = Type::nameForJSExport(Type::lookupApiNotes(tsifyType(IdType())));
+        typeStr = Type::nameForJSExport(Type::lookupApiNotes(tsifyTypeUncached(IdType())));
         break;
       }
       
@@ -782,7 +811,7 @@ string Type::tsifyType(const Type& type, const bool isFuncParam, const bool forC
         if (hasClosed) {
           string arrayType = tsifyType(*interfaceType.typeArguments[0]);
           arrayType = renamedName(arrayType);
-          bool isProtoClass = TypeScript::JSExportDefinitionWriter::overlaidClasses.find(arrayType) != TypeScript::JSExportDefinitionWriter::overlaidClasses.end();
+          bool isProtoClass = TypeScript::JSExportDefinitionWriter::isOverlaidClass(arrayType);
           
           // swift overlay classes
           if (isProtoClass) {
@@ -804,10 +833,10 @@ string Type::tsifyType(const Type& type, const bool isFuncParam, const bool forC
           string genType2 = tsifyType(*interfaceType.typeArguments[1]);
 
           // swift overlay classes
-          if (TypeScript::JSExportDefinitionWriter::overlaidClasses.find(genType1) != TypeScript::JSExportDefinitionWriter::overlaidClasses.end()) {
+          if (TypeScript::JSExportDefinitionWriter::isOverlaidClass(genType1)) {
             genType1 = "NS" + genType1;
           }
-          if (TypeScript::JSExportDefinitionWriter::overlaidClasses.find(genType2) != TypeScript::JSExportDefinitionWriter::overlaidClasses.end()) {
+          if (TypeScript::JSExportDefinitionWriter::isOverlaidClass(genType2)) {
             genType2 = "NS" + genType2;
           }
 
@@ -75,13 +75,17 @@ public:
     static std::map<std::string, YAML::Node> attributesLookup;
     static std::string nameForJSExport(const std::string& jsName) ;
     static std::string lookupApiNotes(std::string type);
+    static const YAML::Node& lookupAttributes(const std::string& key);
     static std::string formatType(const Type& type, const clang::QualType pointerType, const bool ignorePointerType = false);
+    // Formats without the TypeFormatCache, for temporary types which mustn't be cached by their address
+    static std::string formatTypeUncached(const Type& type, const clang::QualType pointerType, const bool ignorePointerType = false);
     static std::string formatTypeId(const ::Meta::IdType& idType, const clang::QualType pointerType, const bool ignorePointerType = false);
     static std::string formatTypePointer(const ::Meta::PointerType& pointerType, const clang::QualType pointerQualType, const bool ignorePointerType = false);
     static std::string formatTypeInterface(const ::Meta::Type& type, const clang::QualType pointerType, const bool ignorePointerType = false);
     static std::string formatTypeAnonymous(const ::Meta::Type& type, const clang::QualType pointerType);
     
     static std::string tsifyType(const Type& type, const bool isFuncParam = false, const bool forComponent = false);
+    static std::string tsifyTypeUncached(const Type& type, const bool isFuncParam = false, const bool forComponent = false);
     static std::string writeFunctionProto(const std::vector<Meta::Type*>& signature);
 
     static void stripModifiersFromPointerType(std::string& name);
@@ -108,6 +112,18 @@ public:
 
     template <class T>
     T visit(TypeVisitor<T>& visitor) const
+    {
+        return dispatch(visitor);
+    }
+
+    /*
+     * \brief Calls the method of the visitor for this type, chosen by the class the visitor is passed as.
+     *
+     * A visitor which doesn't derive from \c TypeVisitor, or is final, has its methods called directly and
+     * inlined into the switch, instead of through the vtable like \c visit does.
+     */
+    template <class Visitor>
+    auto dispatch(Visitor& visitor) const -> decltype(visitor.visitVoid())
     {
         switch (this->type) {
         case TypeVoid:
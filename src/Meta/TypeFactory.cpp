@@ -2,18 +2,19 @@
 #include "CreationException.h"
 #include "MetaFactory.h"
 #include "Utils.h"
+#include "Utils/StaticNameTable.h"
 #include <llvm/ADT/STLExtras.h>
 
 namespace Meta {
 using namespace std;
 
-static const vector<string> KNOWN_BRIDGED_TYPES = {
+static constexpr auto KNOWN_BRIDGED_TYPES = StaticNameTable::makeSet({
 #define CF_TYPE(NAME) #NAME,
 #define NON_CF_TYPE(NAME)
 #include "CFDatabase.def"
 #undef CF_TYPE
 #undef NON_CF_TYPE
-};
+});
 
 shared_ptr<Type> TypeFactory::getVoid()
 {
@@ -438,7 +439,7 @@ shared_ptr<Type> TypeFactory::createFromTypedefType(const clang::TypedefType* ty
     if (auto bridgedInterfaceType = tryCreateFromBridgedType(type->getDecl()->getUnderlyingType().getTypePtrOrNull())) {
         return bridgedInterfaceType;
     }
-    if (isSpecificTypedefType(type, KNOWN_BRIDGED_TYPES)) {
+    if (isKnownBridgedTypedefType(type)) {
         return make_shared<BridgedInterfaceType>("id", nullptr);
     }
     auto decl = type->getDecl();
@@ -515,11 +516,13 @@ bool TypeFactory::isSpecificTypedefType(const clang::TypedefType* type, const st
     return this->isSpecificTypedefType(type, typedefNames);
 }
 
-bool TypeFactory::isSpecificTypedefType(const clang::TypedefType* type, const vector<string>& typedefNames)
+// Whether the typedef or one of the typedefs it is declared with has a name matching isSpecificName
+template <class Predicate>
+static bool isSpecificTypedefTypeChain(const clang::TypedefType* type, Predicate isSpecificName)
 {
     clang::TypedefNameDecl* decl = type->getDecl();
     while (decl) {
-        if (find(typedefNames.begin(), typedefNames.end(), decl->getNameAsString()) != typedefNames.end()) {
+        if (isSpecificName(decl)) {
             return true;
         }
 
@@ -534,6 +537,20 @@ bool TypeFactory::isSpecificTypedefType(const clang::TypedefType* type, const ve
     return false;
 }
 
+bool TypeFactory::isSpecificTypedefType(const clang::TypedefType* type, const vector<string>& typedefNames)
+{
+    return isSpecificTypedefTypeChain(type, [&typedefNames](const clang::TypedefNameDecl* decl) {
+        return find(typedefNames.begin(), typedefNames.end(), decl->getNameAsString()) != typedefNames.end();
+    });
+}
+
+bool TypeFactory::isKnownBridgedTypedefType(const clang::TypedefType* type)
+{
+    return isSpecificTypedefTypeChain(type, [](const clang::TypedefNameDecl* decl) {
+        return KNOWN_BRIDGED_TYPES.contains(decl->getName());
+    });
+}
+
 void TypeFactory::resolveCachedBridgedInterfaceTypes(unordered_map<string, InterfaceMeta*>& interfaceMap)
 {
     unordered_map<string, InterfaceMeta*>::const_iterator nsObjectIt = interfaceMap.find("NSObject");
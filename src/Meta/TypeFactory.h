@@ -105,6 +105,8 @@ private:
 
     bool isSpecificTypedefType(const clang::TypedefType* type, const std::vector<std::string>& typedefNames);
 
+    bool isKnownBridgedTypedefType(const clang::TypedefType* type);
+
     MetaFactory* _metaFactory;
     typedef std::unordered_map<const clang::Type*, std::pair<std::shared_ptr<Type>, std::unique_ptr<CreationException> > > Cache;
     Cache _cache;
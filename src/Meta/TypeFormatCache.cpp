@@ -0,0 +1,29 @@
+#include "TypeFormatCache.h"
+
+namespace Meta {
+using namespace std;
+
+ShardedMemo<TypeFormatCache::Key, string, TypeFormatCache::KeyHash> TypeFormatCache::caches[TypeFormatCache::spellingsCount];
+
+void TypeFormatCache::printStatistics(ostream& out)
+{
+    static const char* spellingNames[spellingsCount] = { "Swift", "TypeScript", "Vue" };
+
+    for (size_t spelling = 0; spelling < spellingsCount; spelling++) {
+        size_t hits = caches[spelling].hits();
+        size_t misses = caches[spelling].computed();
+        if (hits + misses == 0) {
+            continue;
+        }
+        out << "[TypeFormatCache] " << spellingNames[spelling] << ": " << misses << " types formatted, "
+            << hits << " lookups reused (" << (100 * hits / (hits + misses)) << "% hit rate)." << endl;
+    }
+}
+
+void TypeFormatCache::clear()
+{
+    for (auto& cache : caches) {
+        cache.clear();
+    }
+}
+}
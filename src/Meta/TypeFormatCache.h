@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Utils/ShardedMemo.h"
+#include <llvm/ADT/Hashing.h>
+#include <ostream>
+#include <string>
+
+namespace Meta {
+class Type;
+
+/*
+ * \class TypeFormatCache
+ * \brief Remembers how every type has been spelled, so each distinct type is formatted once per target language.
+ *
+ * Entries are keyed by the type, the clang type it was declared with and the formatting flags. The clang type is
+ * the one as written, not the canonical one, because the spellings depend on its sugar (`NSInteger` vs `long`).
+ * Only types which live as long as the run, i.e. the ones created by the TypeFactory, may be cached; recursive
+ * calls on temporaries have to go to the uncached formatters.
+ */
+class TypeFormatCache {
+public:
+    enum class Spelling {
+        Swift, // Type::formatType, used by the JSExport writer
+        TypeScript, // Type::tsifyType
+        Vue, // VueComponentFormatter::formatType
+    };
+
+    // The formatting flags, plain constants so they can be picked with a conditional and or-ed together
+    static const unsigned IgnorePointerType = 1 << 0;
+    static const unsigned IsFuncParam = 1 << 1;
+    static const unsigned ForComponent = 1 << 2;
+
+    template <class Format>
+    static std::string format(Spelling spelling, const Type& type, const void* qualType, unsigned flags, Format formatUncached)
+    {
+        // Formatted without holding a lock, two writers may format the same type but they'll get the same string
+        return caches[static_cast<size_t>(spelling)].get(Key{ &type, qualType, flags }, formatUncached);
+    }
+
+    static void printStatistics(std::ostream& out);
+
+    static void clear();
+
+private:
+    struct Key {
+        const Type* type;
+        const void* qualType;
+        unsigned flags;
+
+        bool operator==(const Key& other) const
+        {
+            return type == other.type && qualType == other.qualType && flags == other.flags;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const
+        {
+            return llvm::hash_combine(key.type, key.qualType, key.flags);
+        }
+    };
+
+    static const size_t spellingsCount = 3;
+
+    // The writers run in parallel, the memo's shards keep them from waiting on each other for every parameter
+    static ShardedMemo<Key, std::string, KeyHash> caches[spellingsCount];
+};
+}
@@ -121,7 +121,7 @@ bool ValidateMetaTypeVisitor::visitInterface(const InterfaceType& typeDetails) {
     }
     
     for (auto typeArg : typeDetails.typeArguments) {
-        typeArg->visit(*this);
+        typeArg->dispatch(*this);
     }
     
     return true;
@@ -136,14 +136,14 @@ bool ValidateMetaTypeVisitor::visitBridgedInterface(const BridgedInterfaceType&
 }
 
 bool ValidateMetaTypeVisitor::visitPointer(const PointerType& typeDetails) {
-    typeDetails.innerType->visit(*this);
+    typeDetails.innerType->dispatch(*this);
     
     return true;
 }
 
 bool ValidateMetaTypeVisitor::visitBlock(const BlockType& typeDetails) {
     for (auto type : typeDetails.signature) {
-        type->visit(*this);
+        type->dispatch(*this);
     }
     
     return true;
@@ -151,7 +151,7 @@ bool ValidateMetaTypeVisitor::visitBlock(const BlockType& typeDetails) {
 
 bool ValidateMetaTypeVisitor::visitFunctionPointer(const FunctionPointerType& typeDetails) {
     for (auto type : typeDetails.signature) {
-        type->visit(*this);
+        type->dispatch(*this);
     }
     
     return true;
@@ -171,7 +171,7 @@ bool ValidateMetaTypeVisitor::visitUnion(const UnionType& typeDetails) {
 
 bool ValidateMetaTypeVisitor::visitAnonymousStruct(const AnonymousStructType& typeDetails) {
     for (auto field : typeDetails.fields) {
-        field.encoding->visit(*this);
+        field.encoding->dispatch(*this);
     }
 
     return true;
@@ -179,7 +179,7 @@ bool ValidateMetaTypeVisitor::visitAnonymousStruct(const AnonymousStructType& ty
 
 bool ValidateMetaTypeVisitor::visitAnonymousUnion(const AnonymousUnionType& typeDetails) {
     for (auto field : typeDetails.fields) {
-        field.encoding->visit(*this);
+        field.encoding->dispatch(*this);
     }
     
     return true;
@@ -196,7 +196,7 @@ bool ValidateMetaTypeVisitor::visitTypeArgument(const TypeArgumentType& typeDeta
         this->_metaFactory.validate(p);
     }
     
-    typeDetails.underlyingType->visit(*this);
+    typeDetails.underlyingType->dispatch(*this);
 
     return true;
 }
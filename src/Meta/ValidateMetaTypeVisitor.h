@@ -10,86 +10,86 @@
 
 #include "MetaFactory.h"
 #include "TypeEntities.h"
-#include "TypeVisitor.h"
 
 using namespace Meta;
 
-class ValidateMetaTypeVisitor : public TypeVisitor<bool> {
+// Visited with Type::dispatch
+class ValidateMetaTypeVisitor final {
     
 public:
     explicit ValidateMetaTypeVisitor(MetaFactory& factory): _metaFactory(factory) { }
 
-    virtual bool visitVoid();
+    bool visitVoid();
     
-    virtual bool visitBool();
+    bool visitBool();
     
-    virtual bool visitShort();
+    bool visitShort();
     
-    virtual bool visitUShort();
+    bool visitUShort();
     
-    virtual bool visitInt();
+    bool visitInt();
     
-    virtual bool visitUInt();
+    bool visitUInt();
     
-    virtual bool visitLong();
+    bool visitLong();
     
-    virtual bool visitUlong();
+    bool visitUlong();
     
-    virtual bool visitLongLong();
+    bool visitLongLong();
     
-    virtual bool visitULongLong();
+    bool visitULongLong();
     
-    virtual bool visitSignedChar();
+    bool visitSignedChar();
     
-    virtual bool visitUnsignedChar();
+    bool visitUnsignedChar();
     
-    virtual bool visitUnichar();
+    bool visitUnichar();
     
-    virtual bool visitCString();
+    bool visitCString();
     
-    virtual bool visitFloat();
+    bool visitFloat();
     
-    virtual bool visitDouble();
+    bool visitDouble();
     
-    virtual bool visitVaList();
+    bool visitVaList();
     
-    virtual bool visitSelector();
+    bool visitSelector();
     
-    virtual bool visitInstancetype();
+    bool visitInstancetype();
     
-    virtual bool visitClass(const ClassType& typeDetails);
+    bool visitClass(const ClassType& typeDetails);
     
-    virtual bool visitProtocol();
+    bool visitProtocol();
     
-    virtual bool visitId(const IdType& typeDetails);
+    bool visitId(const IdType& typeDetails);
     
-    virtual bool visitConstantArray(const ConstantArrayType& typeDetails);
+    bool visitConstantArray(const ConstantArrayType& typeDetails);
     
-    virtual bool visitExtVector(const ExtVectorType& typeDetails);
+    bool visitExtVector(const ExtVectorType& typeDetails);
     
-    virtual bool visitIncompleteArray(const IncompleteArrayType& typeDetails);
+    bool visitIncompleteArray(const IncompleteArrayType& typeDetails);
     
-    virtual bool visitInterface(const InterfaceType& typeDetails);
+    bool visitInterface(const InterfaceType& typeDetails);
     
-    virtual bool visitBridgedInterface(const BridgedInterfaceType& typeDetails);
+    bool visitBridgedInterface(const BridgedInterfaceType& typeDetails);
     
-    virtual bool visitPointer(const PointerType& typeDetails);
+    bool visitPointer(const PointerType& typeDetails);
     
-    virtual bool visitBlock(const BlockType& typeDetails);
+    bool visitBlock(const BlockType& typeDetails);
     
-    virtual bool visitFunctionPointer(const FunctionPointerType& typeDetails);
+    bool visitFunctionPointer(const FunctionPointerType& typeDetails);
     
-    virtual bool visitStruct(const StructType& typeDetails);
+    bool visitStruct(const StructType& typeDetails);
     
-    virtual bool visitUnion(const UnionType& typeDetails);
+    bool visitUnion(const UnionType& typeDetails);
     
-    virtual bool visitAnonymousStruct(const AnonymousStructType& typeDetails);
+    bool visitAnonymousStruct(const AnonymousStructType& typeDetails);
     
-    virtual bool visitAnonymousUnion(const AnonymousUnionType& typeDetails);
+    bool visitAnonymousUnion(const AnonymousUnionType& typeDetails);
     
-    virtual bool visitEnum(const EnumType& typeDetails);
+    bool visitEnum(const EnumType& typeDetails);
     
-    virtual bool visitTypeArgument(const ::Meta::TypeArgumentType& type);
+    bool visitTypeArgument(const ::Meta::TypeArgumentType& type);
 
     
 private:
@@ -1,14 +1,20 @@
 #include "Binary/binarySerializer.h"
 #include "HeadersParser/Parser.h"
 #include "Meta/DeclarationConverterVisitor.h"
+#include "Meta/Filters/FilterPassManager.h"
 #include "Meta/Filters/HandleExceptionalMetasFilter.h"
 #include "Meta/Filters/HandleMethodsAndPropertiesWithSameNameFilter.h"
 #include "Meta/Filters/MergeCategoriesFilter.h"
 #include "Meta/Filters/ModulesBlocklist.h"
 #include "Meta/Filters/RemoveDuplicateMembersFilter.h"
 #include "Meta/Filters/ResolveGlobalNamesCollisionsFilter.h"
+#include "Meta/TypeFormatCache.h"
 #include "TypeScript/DefinitionWriter.h"
 #include "TypeScript/DocSetManager.h"
+#include "TypeScript/InheritanceCache.h"
+#include "TypeScript/OutputDirectories.h"
+#include "TypeScript/OutputFiles.h"
+#include "TypeScript/OutputScheduler.h"
 #include "Vue/VueComponentDefinitionWriter.h"
 #include "JSExport/JSExportDefinitionWriter.h"
 #include "Yaml/YamlSerializer.h"
@@ -16,7 +22,10 @@
 #include <clang/Tooling/Tooling.h>
 #include <fstream>
 #include <llvm/Support/Debug.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Path.h>
+#include <mutex>
 #include <pwd.h>
 #include <sstream>
 #include <thread>
@@ -27,14 +36,22 @@ llvm::cl::opt<string> cla_outputBinFile("output-bin", llvm::cl::desc("Specify th
 llvm::cl::opt<string> cla_outputDtsFolder("output-typescript", llvm::cl::desc("Specify the output .d.ts folder"), llvm::cl::value_desc("<dir_path>"));
 llvm::cl::opt<string> cla_outputJSEFolder("output-jsexport", llvm::cl::desc("Specify the output folder for .swift JSExport files"), llvm::cl::value_desc("<dir_path>"));
 llvm::cl::opt<string> cla_outputVueFolder("output-vue", llvm::cl::desc("Specify the output folder for .vue components"), llvm::cl::value_desc("<dir_path>"));
+llvm::cl::opt<bool>   cla_typescriptPerFramework("typescript-per-framework", llvm::cl::desc("Write the TypeScript declarations of every framework to its own file, with MacOS.ts exporting all of them"), llvm::cl::value_desc("bool"));
+llvm::cl::opt<bool>   cla_jsexportPerFramework("jsexport-per-framework", llvm::cl::desc("Write the JSExport definitions of every framework to a few files with the imports written once, instead of a file per class and protocol"), llvm::cl::value_desc("bool"));
+llvm::cl::opt<unsigned> cla_jsexportMaxFileSize("jsexport-max-file-size", llvm::cl::desc("Split the files of -jsexport-per-framework at about this many bytes, 0 for a single file per framework"), llvm::cl::value_desc("bytes"), llvm::cl::init(1 << 20));
+llvm::cl::opt<bool>   cla_jsexportInheritance("jsexport-inheritance", llvm::cl::desc("Declare inherited static methods only in the export protocol of the superclass instead of in every subclass"), llvm::cl::value_desc("bool"));
+llvm::cl::opt<bool>   cla_writeIfChanged("write-if-changed", llvm::cl::desc("Only rewrite output files whose content changed"), llvm::cl::value_desc("bool"));
+llvm::cl::opt<string> cla_outputManifest("output-manifest", llvm::cl::desc("Specify the manifest listing the changed, unchanged and removed output files, implies -write-if-changed"), llvm::cl::value_desc("<file_path>"));
 llvm::cl::opt<bool>   cla_verbose("verbose", llvm::cl::desc("Set verbose output mode"), llvm::cl::value_desc("bool"));
 llvm::cl::opt<string> cla_docSetFile("docset-path", llvm::cl::desc("Specify the path to the iOS SDK docset package"), llvm::cl::value_desc("<file_path>"));
+llvm::cl::opt<string> cla_docSetCache("docset-cache", llvm::cl::desc("Specify a file keeping the comments read from the docset between runs"), llvm::cl::value_desc("<file_path>"));
 
 class MetaGenerationConsumer : public clang::ASTConsumer {
 public:
-  explicit MetaGenerationConsumer(clang::SourceManager& sourceManager, clang::HeaderSearch& headerSearch, Meta::ModulesBlocklist& modulesBlocklist)
+  explicit MetaGenerationConsumer(clang::SourceManager& sourceManager, clang::HeaderSearch& headerSearch, Meta::ModulesBlocklist& modulesBlocklist, Meta::ExceptionalMetasRules& exceptionalMetasRules)
   : _headerSearch(headerSearch)
-  , _visitor(sourceManager, _headerSearch, cla_verbose, modulesBlocklist)
+  , _exceptionalMetasRules(exceptionalMetasRules)
+  , _visitor(sourceManager, _headerSearch, cla_verbose, modulesBlocklist, exceptionalMetasRules)
   {
   }
 
@@ -55,12 +72,27 @@ public:
     list<Meta::Meta*>& metaContainer = _visitor.generateMetadata(Context.getTranslationUnitDecl());
     
     // Filters
-    Meta::HandleExceptionalMetasFilter().filter(metaContainer);
-    Meta::MergeCategoriesFilter().filter(metaContainer);
-    Meta::RemoveDuplicateMembersFilter().filter(metaContainer);
-    Meta::HandleMethodsAndPropertiesWithSameNameFilter(_visitor.getMetaFactory()).filter(metaContainer);
-    Meta::ResolveGlobalNamesCollisionsFilter filter = Meta::ResolveGlobalNamesCollisionsFilter();
-    filter.filter(metaContainer);
+    Meta::RemoveDuplicateMembersFilter removeDuplicateMembersFilter;
+    Meta::HandleMethodsAndPropertiesWithSameNameFilter sameNameFilter(_visitor.getMetaFactory());
+    Meta::ResolveGlobalNamesCollisionsFilter filter;
+    
+    Meta::FilterPassManager passManager;
+    passManager.addPass({ "HandleExceptionalMetas", Meta::FilterScope::Global, {}, nullptr,
+      [this](clang::Module*, list<Meta::Meta*>& metas) { Meta::HandleExceptionalMetasFilter(_exceptionalMetasRules).filter(metas); }, nullptr });
+    passManager.addPass({ "MergeCategories", Meta::FilterScope::Global, { "HandleExceptionalMetas" }, nullptr,
+      [](clang::Module*, list<Meta::Meta*>& metas) { Meta::MergeCategoriesFilter().filter(metas); }, nullptr });
+    passManager.addPass({ "RemoveDuplicateMembers", Meta::FilterScope::TopLevelModule, { "MergeCategories" },
+      [&removeDuplicateMembersFilter](list<Meta::Meta*>& container) { removeDuplicateMembersFilter.snapshot(container); },
+      [&removeDuplicateMembersFilter](clang::Module*, list<Meta::Meta*>& metas) { removeDuplicateMembersFilter.filter(metas); }, nullptr });
+    // Creates property metas through the shared MetaFactory, so it has to stay global
+    passManager.addPass({ "HandleMethodsAndPropertiesWithSameName", Meta::FilterScope::Global, { "RemoveDuplicateMembers" }, nullptr,
+      [&sameNameFilter](clang::Module*, list<Meta::Meta*>& metas) { sameNameFilter.filter(metas); }, nullptr });
+    passManager.addPass({ "ResolveGlobalNamesCollisions", Meta::FilterScope::TopLevelModule, { "HandleMethodsAndPropertiesWithSameName" },
+      [&filter](list<Meta::Meta*>& container) { filter.group(container); },
+      [&filter](clang::Module* topLevelModule, list<Meta::Meta*>&) { filter.resolveCollisions(topLevelModule); },
+      [&filter](list<Meta::Meta*>&) { filter.logStatistics(); } });
+    passManager.run(metaContainer);
+    
     unique_ptr<pair<Meta::ResolveGlobalNamesCollisionsFilter::MetasByModules, Meta::ResolveGlobalNamesCollisionsFilter::InterfacesByName> > result = filter.getResult();
     Meta::ResolveGlobalNamesCollisionsFilter::MetasByModules& metasByModules = result->first;
     
@@ -86,6 +118,17 @@ public:
     //      }
     //    }
     
+    // Every writer adds its per module jobs to the scheduler, they all run in parallel
+    TypeScript::OutputScheduler scheduler;
+    Meta::TypeFactory& typeFactory = _visitor.getMetaFactory().getTypeFactory();
+    string docSetPath = cla_docSetFile.empty() ? "" : cla_docSetFile.getValue();
+    TypeScript::DocSetManager::initialize(docSetPath, cla_docSetCache);
+    TypeScript::InheritanceCache::build(metasByModules);
+    
+    if (cla_writeIfChanged || !cla_outputManifest.empty()) {
+      TypeScript::OutputFiles::enableWriteIfChanged(cla_outputManifest);
+    }
+    
     // Serialize Meta objects to Yaml
     if (!cla_outputYamlFolder.empty()) {
       if (!llvm::sys::fs::exists(cla_outputYamlFolder)) {
@@ -94,9 +137,11 @@ public:
       }
       
       for (pair<clang::Module*, vector<Meta::Meta*> >& modulePair : metasByModules) {
-        string yamlFileName = modulePair.first->getFullModuleName() + ".yaml";
-        DEBUG_WITH_TYPE("yaml", llvm::dbgs() << "Generating: " << yamlFileName << "\n");
-        Yaml::YamlSerializer::serialize<pair<clang::Module*, vector<Meta::Meta*> > >(cla_outputYamlFolder + "/" + yamlFileName, modulePair);
+        scheduler.addJob(modulePair.second.size(), [&modulePair]() {
+          string yamlFileName = modulePair.first->getFullModuleName() + ".yaml";
+          DEBUG_WITH_TYPE("yaml", llvm::dbgs() << "Generating: " << yamlFileName << "\n");
+          Yaml::YamlSerializer::serialize<pair<clang::Module*, vector<Meta::Meta*> > >(cla_outputYamlFolder + "/" + yamlFileName, modulePair);
+        });
       }
     }
     
@@ -111,98 +156,241 @@ public:
     // Generate JSExport definitions
     if (!cla_outputJSEFolder.empty()) {
       llvm::sys::fs::create_directories(cla_outputJSEFolder);
-      string docSetPath = cla_docSetFile.empty() ? "" : cla_docSetFile.getValue();
       
+      // Create the framework folders up front, so the writers only open the files
       for (pair<clang::Module*, vector<Meta::Meta*> >& modulePair : metasByModules) {
-        cout<< "[JSExport] " << modulePair.first->Name << "... ";
-        TypeScript::JSExportDefinitionWriter jsDefinitionWriter(modulePair, _visitor.getMetaFactory().getTypeFactory(), docSetPath);
-        jsDefinitionWriter.write();
-        cout << std::to_string(modulePair.second.size()) << " done" << endl;
+        if (modulePair.second.empty()) {
+          continue;
+        }
+        string frameworkPath = TypeScript::JSExportDefinitionWriter::outputJSEFolder + "/" + modulePair.first->Name + "/";
+        TypeScript::OutputDirectories::create(frameworkPath);
+        bool hasProtocols = any_of(modulePair.second.begin(), modulePair.second.end(), [](Meta::Meta* meta) {
+          return meta->is(Meta::MetaType::Protocol);
+        });
+        if (hasProtocols && !TypeScript::JSExportDefinitionWriter::perFramework) {
+          TypeScript::OutputDirectories::create(frameworkPath + "protocols/");
+        }
       }
       
-      cout << endl;
+      for (pair<clang::Module*, vector<Meta::Meta*> >& modulePair : metasByModules) {
+        scheduler.addJob(modulePair.second.size(), [&modulePair, &typeFactory, docSetPath]() {
+          TypeScript::OutputScheduler::out() << "[JSExport] " << modulePair.first->Name << "... ";
+          TypeScript::JSExportDefinitionWriter jsDefinitionWriter(modulePair, typeFactory, docSetPath);
+          jsDefinitionWriter.write();
+          TypeScript::OutputScheduler::out() << std::to_string(modulePair.second.size()) << " done" << endl;
+        });
+      }
+      
+      scheduler.addMessage("\n");
     }
     
     // Generate component definitions
     if (!cla_outputVueFolder.empty()) {
       llvm::sys::fs::create_directories(cla_outputVueFolder);
-      string docSetPath = cla_docSetFile.empty() ? "" : cla_docSetFile.getValue();
       
-      cout << "Generating Vue components..." << endl;
+      for (pair<clang::Module*, vector<Meta::Meta*> >& modulePair : metasByModules) {
+        if (!modulePair.second.empty()) {
+          TypeScript::OutputDirectories::create(TypeScript::VueComponentDefinitionWriter::outputVueFolder + "/" + modulePair.first->Name + "/");
+        }
+      }
+      
+      scheduler.addMessage("Generating Vue components...\n");
       
+      // The components of a module depend on the props written for the modules before it
       for (pair<clang::Module*, vector<Meta::Meta*> >& modulePair : metasByModules) {
-        cout << "[Vue] " << modulePair.first->Name << "... ";
-        TypeScript::VueComponentDefinitionWriter vueDefinitionWriter(modulePair, _visitor.getMetaFactory().getTypeFactory(), docSetPath);
-        vueDefinitionWriter.write();
-        cout << std::to_string(modulePair.second.size()) << " done" << endl;
+        scheduler.addJob(modulePair.second.size(), [&modulePair, &typeFactory, docSetPath]() {
+          TypeScript::OutputScheduler::out() << "[Vue] " << modulePair.first->Name << "... ";
+          TypeScript::VueComponentDefinitionWriter vueDefinitionWriter(modulePair, typeFactory, docSetPath);
+          vueDefinitionWriter.write();
+          TypeScript::OutputScheduler::out() << std::to_string(modulePair.second.size()) << " done" << endl;
+        }, "vue");
       }
     }
     
     // Generate TypeScript definitions
+    unique_ptr<TypeScript::OutputFile> dtsFile;
+    llvm::SmallString<128> dtsPath;
+    vector<unique_ptr<TypeScript::DefinitionWriter> > definitionWriters;
+    
+    // The declarations of a module are written as soon as the modules before it are written. The scheduler
+    // starts the largest modules first, so the ones finished out of order are spilled to temporary files
+    // and only the modules being written are held in memory.
+    mutex definitionsMutex;
+    vector<string> definitions(metasByModules.size());
+    vector<string> definitionSpills(metasByModules.size());
+    vector<bool> definitionsDone(metasByModules.size(), false);
+    size_t definitionsWritten = 0;
+    
+    // Keeps the declarations in memory if they can't be spilled
+    auto spillDefinition = [&definitions, &definitionSpills](size_t i, string& definition) {
+      llvm::SmallString<128> spillPath;
+      int spillFd;
+      if (!llvm::sys::fs::createTemporaryFile("definitions", "ts", spillFd, spillPath)) {
+        llvm::raw_fd_ostream spill(spillFd, true);
+        spill << definition;
+        spill.close();
+        if (!spill.has_error()) {
+          definitionSpills[i] = spillPath.str().str();
+          string().swap(definition);
+          return;
+        }
+        spill.clear_error();
+        llvm::sys::fs::remove(spillPath);
+      }
+      definitions[i] = move(definition);
+    };
+    
+    auto takeDefinition = [&definitions, &definitionSpills](size_t i) {
+      string definition;
+      if (definitionSpills[i].empty()) {
+        definition.swap(definitions[i]);
+        return definition;
+      }
+      auto spill = llvm::MemoryBuffer::getFile(definitionSpills[i]);
+      if (spill) {
+        definition = (*spill)->getBuffer().str();
+      } else {
+        cout << definitionSpills[i] << ": " << spill.getError().message() << endl;
+      }
+      llvm::sys::fs::remove(definitionSpills[i]);
+      definitionSpills[i].clear();
+      return definition;
+    };
+    
     if (!cla_outputDtsFolder.empty()) {
-      ostringstream output;
-      
       llvm::sys::fs::create_directories(cla_outputDtsFolder);
-      string docSetPath = cla_docSetFile.empty() ? "" : cla_docSetFile.getValue();
       
-      llvm::SmallString<128> path;
-      llvm::sys::path::append(path, cla_outputDtsFolder, "MacOS.ts");
-      error_code error;
-      llvm::raw_fd_ostream file(path.str(), error, llvm::sys::fs::F_Text);
+      llvm::sys::path::append(dtsPath, cla_outputDtsFolder, "MacOS.ts");
+      dtsFile.reset(new TypeScript::OutputFile(dtsPath.c_str()));
       
-      if (error) {
-        cout << error.message();
-        return;
+      if (dtsFile->error()) {
+        cout << dtsFile->error().message();
+        dtsFile.reset();
       }
+    }
+    
+    if (dtsFile) {
+      scheduler.addMessage("Generating TypeScript definitions...\n");
       
-      cout << "Generating TypeScript definitions..." << endl;
-      
-      output << "/* eslint-disable */\n\n";
+      *dtsFile << "/* eslint-disable */\n\n";
       
       // These are all inside a declare block, so they are invisible
       // and runtime, we add the enums to the bridges classes later
       
-      output << "declare global {\n\n";
+      if (!cla_typescriptPerFramework) {
+        *dtsFile << "declare global {\n\n";
+      }
       
+      // Methods of every module may return enums of any module, so all of them are known before writing
       for (pair<clang::Module*, vector<Meta::Meta*> >& modulePair : metasByModules) {
-        cout << "[Typescript] " << modulePair.first->Name << "... ";
-        TypeScript::DefinitionWriter definitionWriter(modulePair, _visitor.getMetaFactory().getTypeFactory(), docSetPath);
-        output << definitionWriter.visitAll();
-        cout << std::to_string(modulePair.second.size()) << " done" << endl;
+        definitionWriters.emplace_back(new TypeScript::DefinitionWriter(modulePair, typeFactory, docSetPath));
+        definitionWriters.back()->registerEnums();
       }
       
-      cout << endl;
+      TypeScript::OutputFile& file = *dtsFile;
+      for (size_t i = 0; i < metasByModules.size(); i++) {
+        pair<clang::Module*, vector<Meta::Meta*> >& modulePair = metasByModules[i];
+        scheduler.addJob(modulePair.second.size(), [&, i]() {
+          TypeScript::OutputScheduler::out() << "[Typescript] " << modulePair.first->Name << "... ";
+          string definition = definitionWriters[i]->visitAll();
+          TypeScript::OutputScheduler::out() << std::to_string(modulePair.second.size()) << " done" << endl;
+          
+          unique_lock<mutex> lock(definitionsMutex);
+          // The file of a framework also holds its namespaces, so it's written when all modules are done
+          if (cla_typescriptPerFramework || i != definitionsWritten) {
+            lock.unlock();
+            spillDefinition(i, definition);
+            lock.lock();
+          } else {
+            definitions[i] = move(definition);
+          }
+          definitionsDone[i] = true;
+          for (; definitionsWritten < definitions.size() && definitionsDone[definitionsWritten]; definitionsWritten++) {
+            if (!cla_typescriptPerFramework) {
+              file << takeDefinition(definitionsWritten);
+            }
+            definitionWriters[definitionsWritten]->commitNamespaces();
+          }
+        });
+      }
       
+      scheduler.addMessage("\n");
+    }
+    
+    scheduler.run();
+    
+    if (dtsFile) {
       const char * namespaceFills = R"__literal(namespace AE {
       export enum AEDataModel { }
       })__literal";
       
-      output << namespaceFills << endl;
-      
-      output << TypeScript::DefinitionWriter::writeNamespaces();
-      
-      output << "}\n\n";
-      
-      output << "// Add enums to the already-existing bridged classes\n";
-      output << "//\n";
-      output << "// If we didn't do this, these would be duplicated\n";
-      output << "// (i.e. both NSButton and NSButton$1 would exist\n";
-      output << "// in global scope)\n\n";
-      
-      output << "let global = globalThis as any;\n\n";
-      
-      output << TypeScript::DefinitionWriter::writeNamespaces(true);
+      if (cla_typescriptPerFramework) {
+        for (size_t i = 0; i < metasByModules.size(); i++) {
+          string moduleName = metasByModules[i].first->Name;
+          llvm::SmallString<128> modulePath;
+          llvm::sys::path::append(modulePath, cla_outputDtsFolder, moduleName + ".ts");
+          
+          TypeScript::OutputFile moduleFile(modulePath.c_str());
+          moduleFile << "/* eslint-disable */\n\n";
+          moduleFile << "declare global {\n\n";
+          moduleFile << takeDefinition(i);
+          moduleFile << TypeScript::DefinitionWriter::writeNamespaces(false, moduleName);
+          moduleFile << "}\n\n";
+          moduleFile << "let global = globalThis as any;\n\n";
+          moduleFile << TypeScript::DefinitionWriter::writeNamespaces(true, moduleName);
+          moduleFile << TypeScript::DefinitionWriter::writeExports(moduleName);
+          
+          error_code error = moduleFile.close();
+          
+          if (error) {
+            cout << modulePath.c_str() << ": " << error.message() << endl;
+          }
+          
+          *dtsFile << "export * from './" << moduleName << "';\n";
+        }
+        
+        *dtsFile << "\ndeclare global {\n\n";
+        *dtsFile << namespaceFills << "\n";
+        *dtsFile << "}\n";
+      } else {
+        *dtsFile << namespaceFills << "\n";
+        
+        *dtsFile << TypeScript::DefinitionWriter::writeNamespaces();
+        
+        *dtsFile << "}\n\n";
+        
+        *dtsFile << "// Add enums to the already-existing bridged classes\n";
+        *dtsFile << "//\n";
+        *dtsFile << "// If we didn't do this, these would be duplicated\n";
+        *dtsFile << "// (i.e. both NSButton and NSButton$1 would exist\n";
+        *dtsFile << "// in global scope)\n\n";
+        
+        *dtsFile << "let global = globalThis as any;\n\n";
+        
+        *dtsFile << TypeScript::DefinitionWriter::writeNamespaces(true);
+        
+        *dtsFile << TypeScript::DefinitionWriter::writeExports();
+      }
       
-      output << TypeScript::DefinitionWriter::writeExports();
+      TypeScript::DefinitionWriter::clearNamespaces();
       
-      file << output.str();
-      file.close();
+      error_code error = dtsFile->close();
       
-      cout << "Wrote " << path.c_str() << endl << endl;
+      if (error) {
+        cout << error.message();
+      } else {
+        cout << "Wrote " << dtsPath.c_str() << endl << endl;
+      }
     }
+    
+    TypeScript::OutputFiles::writeManifest();
+    TypeScript::DocSetManager::saveCache();
+    
+    Meta::TypeFormatCache::printStatistics(cout);
   }
   
 private:
   clang::HeaderSearch& _headerSearch;
+  Meta::ExceptionalMetasRules& _exceptionalMetasRules;
   Meta::DeclarationConverterVisitor _visitor;
 };
@@ -25,8 +25,9 @@ llvm::cl::opt<bool>   cla_strictIncludes("strict-includes", llvm::cl::desc("Set
 
 class MetaGenerationFrontendAction : public clang::ASTFrontendAction {
 public:
-  MetaGenerationFrontendAction(Meta::ModulesBlocklist& modulesBlocklist)
+  MetaGenerationFrontendAction(Meta::ModulesBlocklist& modulesBlocklist, Meta::ExceptionalMetasRules& exceptionalMetasRules)
   : _modulesBlocklist(modulesBlocklist)
+  , _exceptionalMetasRules(exceptionalMetasRules)
   {
   }
 
@@ -37,10 +38,11 @@ public:
     // here we set this explicitly in order to keep the same behavior
     Compiler.getPreprocessor().SetSuppressIncludeNotFoundError(!cla_strictIncludes);
 
-    return unique_ptr<clang::ASTConsumer>(new MetaGenerationConsumer(Compiler.getASTContext().getSourceManager(), Compiler.getPreprocessor().getHeaderSearchInfo(), _modulesBlocklist));
+    return unique_ptr<clang::ASTConsumer>(new MetaGenerationConsumer(Compiler.getASTContext().getSourceManager(), Compiler.getPreprocessor().getHeaderSearchInfo(), _modulesBlocklist, _exceptionalMetasRules));
   }
 
 private:
   Meta::ModulesBlocklist& _modulesBlocklist;
+  Meta::ExceptionalMetasRules& _exceptionalMetasRules;
 };
 
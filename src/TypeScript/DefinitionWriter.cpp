@@ -1,14 +1,20 @@
 #include "DefinitionWriter.h"
+#include "InheritanceCache.h"
+#include "MemberLowering.h"
 #include "Meta/Utils.h"
 #include "Meta/NameRetrieverVisitor.h"
 #include "Meta/MetaFactory.h"
+#include "OutputScheduler.h"
+#include "Utils/StaticNameTable.h"
 #include "Utils/StringUtils.h"
+#include "JSExport/ExportedClasses.h"
 #include "JSExport/JSExportDefinitionWriter.h"
 #include "Vue/VueComponentFormatter.h"
 #include "yaml-cpp/yaml.h"
 #include <algorithm>
 #include <clang/AST/DeclObjC.h>
 #include <iterator>
+#include <mutex>
 
 namespace TypeScript {
 using namespace Meta;
@@ -18,7 +24,9 @@ bool DefinitionWriter::applyManualChanges = false;
 
 string dataRoot = getenv("DATAPATH");
 
+// Filled by registerEnums() before any module is written, only read while writing
 static map<string, map<string, map<string, EnumMeta*>>> namespaceEnums = {};
+// Merged from the writers of all modules by commitNamespaces()
 static map<string, vector<VarMeta*>> namespaceVars = {};
 static map<string, vector<string>> namespaceClasses = {};
 static vector<InterfaceMeta*> namespaceViews = {};
@@ -26,8 +34,44 @@ static map<string, bool> allNamespaces = {};
 static map<string, bool> allClasses = {};
 static map<string, bool> allInterfaces = {};
 static map<string, map<string, string>> namespaceTypealiases = {};
+// The top level module whose declaration file a namespace is written to, the first module declaring it
+static map<string, string> namespaceOwners = {};
+// The namespace records of allNamespaces which are written to the declaration file of a module
+static map<string, map<string, bool>> moduleNamespaces = {};
 
-static unordered_set<string> hiddenMethods = {
+static mutex typeFactoryMutex;
+
+// Whether an enum is nested in a class, e.g. NSTypesetter.NSTypesetterControlCharacterAction
+static bool isContainedEnum(const string& className, const string& enumName)
+{
+  auto namespaceIt = namespaceEnums.find(className);
+  if (namespaceIt == namespaceEnums.end()) {
+    return false;
+  }
+  auto containerIt = namespaceIt->second.find("_container");
+  if (containerIt == namespaceIt->second.end()) {
+    return false;
+  }
+  auto enumIt = containerIt->second.find(enumName);
+  return enumIt != containerIt->second.end() && enumIt->second != NULL;
+}
+
+// The namespace a record of allNamespaces is written to, e.g. NSButton for NSButton.BezelStyle
+static string namespaceNameOf(const string& namespaceRecord)
+{
+  string namespaceName = renamedName(namespaceRecord);
+  
+  vector<string> namespaceNameTokens;
+  StringUtils::split(namespaceName, '.', back_inserter(namespaceNameTokens));
+  
+  if (namespaceNameTokens.size() == 2) {
+    namespaceName = namespaceNameTokens[0];
+  }
+  
+  return namespaceName;
+}
+
+static constexpr auto hiddenMethods = StaticNameTable::makeSet({
   "retain",
   "release",
   "autorelease",
@@ -38,7 +82,7 @@ static unordered_set<string> hiddenMethods = {
   "prototype",
   "countByEnumeratingWithStateObjectsCount",
   "create"
-};
+});
 
 static unordered_set<string> ignoredNamespaces = {
   "Array",
@@ -49,7 +93,7 @@ static unordered_set<string> ignoredNamespaces = {
   "Error"
 };
 
-static unordered_set<string> bannedIdentifiers = {
+static constexpr auto bannedIdentifiers = StaticNameTable::makeSet({
   "arguments",
   "break",
   "case",
@@ -86,10 +130,14 @@ static unordered_set<string> bannedIdentifiers = {
   "while",
   "with",
   "yield"
-};
+});
 
 void populateTypealiases()
 {
+  if (!namespaceTypealiases.empty()) {
+    return;
+  }
+  
   string aliasesPath = dataRoot + "/aliases.json";
   
   auto aliasNode = YAML::LoadFile(aliasesPath);
@@ -108,7 +156,7 @@ void populateTypealiases()
 
 static string sanitizeParameterName(const string& parameterName)
 {
-  if (bannedIdentifiers.find(parameterName) != bannedIdentifiers.end()) {
+  if (bannedIdentifiers.contains(parameterName)) {
     return parameterName + "_";
   }
   else {
@@ -118,7 +166,7 @@ static string sanitizeParameterName(const string& parameterName)
 
 static string getTypeParametersStringOrEmpty(const clang::ObjCInterfaceDecl* interfaceDecl)
 {
-  ostringstream output;
+  EmissionBuffer output;
   if (clang::ObjCTypeParamList* typeParameters = interfaceDecl->getTypeParamListAsWritten()) {
     if (typeParameters->size()) {
       output << "<";
@@ -159,7 +207,7 @@ void getClosedGenericsIfAny(Type& type, vector<Type*>& params)
     }
   } else if (type.is(TypeTypeArgument)) {
     TypeArgumentType* typeArg = &type.as<TypeArgumentType>();
-    if (typeArg->visit(NameRetrieverVisitor::instanceTs) != "") {
+    if (!typeArg->dispatch(NameRetrieverVisitor::instanceTs).empty()) {
       if (find(params.begin(), params.end(), typeArg) == params.end()) {
         params.push_back(typeArg);
       }
@@ -169,7 +217,7 @@ void getClosedGenericsIfAny(Type& type, vector<Type*>& params)
 
 string DefinitionWriter::jsifySwiftTypeName(const string& jsName)
 {
-  static map<string, string> jsNames = {
+  static constexpr auto jsNames = StaticNameTable::makeMap({
     { "Decimal", "number" },
     { "CGFloat", "number" },
     { "Float", "number" },
@@ -193,13 +241,14 @@ string DefinitionWriter::jsifySwiftTypeName(const string& jsName)
     { "AnyClass", "any" },
     { "AnyObject", "any" },
     { "Bool", "boolean" }
-  };
+  });
   
-  if (!jsNames[jsName].empty()) {
-    return jsNames[jsName];
+  llvm::StringRef jsType = jsNames.lookup(jsName);
+  if (!jsType.empty()) {
+    return jsType.str();
   }
   
-  bool isProtoClass = JSExportDefinitionWriter::overlaidClasses.find(jsName) != JSExportDefinitionWriter::overlaidClasses.end();
+  bool isProtoClass = JSExportDefinitionWriter::isOverlaidClass(jsName);
   
   // swift overlay classes
   if (isProtoClass) {
@@ -211,12 +260,18 @@ string DefinitionWriter::jsifySwiftTypeName(const string& jsName)
 
 string DefinitionWriter::getTypeArgumentsStringOrEmpty(const clang::ObjCObjectType* objectType)
 {
-  ostringstream output;
+  EmissionBuffer output;
   llvm::ArrayRef<clang::QualType> typeArgs = objectType->getTypeArgsAsWritten();
   if (!typeArgs.empty()) {
     output << "<";
     for (unsigned i = 0; i < typeArgs.size(); i++) {
-      auto typeName = VueComponentFormatter::current.formatType(*_typeFactory.create(typeArgs[i]), typeArgs[i]);
+      shared_ptr<Type> typeArg;
+      {
+        // The type factory is shared by the writers of all modules
+        lock_guard<mutex> lock(typeFactoryMutex);
+        typeArg = _typeFactory.create(typeArgs[i]);
+      }
+      auto typeName = VueComponentFormatter::current.formatType(*typeArg, typeArgs[i]);
       output << typeName;
       if (i < typeArgs.size() - 1) {
         output << ", ";
@@ -246,58 +301,6 @@ string DefinitionWriter::getTypeArgumentsStringOrEmpty(const clang::ObjCObjectTy
   return output.str();
 }
 
-void DefinitionWriter::getInheritedMembersRecursive(InterfaceMeta* interface,
-                                                    CompoundMemberMap<MethodMeta>* staticMethods,
-                                                    CompoundMemberMap<MethodMeta>* instanceMethods,
-                                                    CompoundMemberMap<PropertyMeta>* staticProperties,
-                                                    CompoundMemberMap<PropertyMeta>* instanceProperties)
-{
-  auto base = interface->base;
-  if (!base) {
-    return;
-  }
-  
-  if (staticMethods) {
-    for (MethodMeta* method : base->staticMethods) {
-      if (staticMethods->find(method->name) == staticMethods->end()) {
-        staticMethods->emplace(method->name, make_pair(base, method));
-      }
-    }
-  }
-  
-  if (instanceMethods) {
-    for (MethodMeta* method : base->instanceMethods) {
-      if (instanceMethods->find(method->name) == instanceMethods->end()) {
-        instanceMethods->emplace(method->name, make_pair(base, method));
-      }
-    }
-  }
-  
-  if (staticProperties) {
-    for (PropertyMeta* property : base->staticProperties) {
-      if (staticProperties->find(property->name) == staticProperties->end()) {
-        staticProperties->emplace(property->name, make_pair(base, property));
-      }
-    }
-  }
-  
-  if (instanceProperties) {
-    for (PropertyMeta* property : base->instanceProperties) {
-      if (instanceProperties->find(property->name) == instanceProperties->end()) {
-        instanceProperties->emplace(property->name, make_pair(base, property));
-      }
-    }
-  }
-  
-  // accumulate...
-  unordered_set<ProtocolMeta*> protocols;
-  for (auto protocol : base->protocols) {
-    getProtocolMembersRecursive(protocol, staticMethods, instanceMethods, staticProperties, instanceProperties, protocols);
-  }
-  
-  getInheritedMembersRecursive(base, staticMethods, instanceMethods, staticProperties, instanceProperties);
-}
-
 void DefinitionWriter::getProtocolMembersRecursive(ProtocolMeta* protocolMeta,
                                                    CompoundMemberMap<MethodMeta>* staticMethods,
                                                    CompoundMemberMap<MethodMeta>* instanceMethods,
@@ -380,7 +383,7 @@ bool DefinitionWriter::getTypeOptional(clang::ASTContext &Ctx, clang::Decl::ObjC
 }
 
 string DefinitionWriter::getInstanceParamsStr(MethodMeta* method, BaseClassMeta* owner) {
-  vector<string> argumentLabels = method->argLabels;
+  const vector<string>& argumentLabels = method->argLabels;
   
   string output = "";
   const clang::ObjCMethodDecl& methodDecl = *clang::dyn_cast<clang::ObjCMethodDecl>(method->declaration);
@@ -514,7 +517,7 @@ string DefinitionWriter::getInstanceParamsStr(MethodMeta* method, BaseClassMeta*
 
 void DefinitionWriter::visit(InterfaceMeta* meta)
 {
-  ostringstream out;
+  EmissionBuffer out;
   
   CompoundMemberMap<MethodMeta> compoundStaticMethods;
   for (MethodMeta* method : meta->staticMethods) {
@@ -544,9 +547,7 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
   
   unordered_set<ProtocolMeta*> inheritedProtocols;
   
-  CompoundMemberMap<MethodMeta> inheritedStaticMethods;
-  
-  getInheritedMembersRecursive(meta, &inheritedStaticMethods, nullptr, nullptr, nullptr);
+  const CompoundMemberMap<MethodMeta>& inheritedStaticMethods = InheritanceCache::inheritedStaticMethods(meta, InheritanceCache::Key::Name);
   
   for (auto& methodPair : inheritedStaticMethods) {
     MethodMeta* method = methodPair.second.second;
@@ -577,7 +578,7 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
     metaName = metaNameTokens[1];
   }
   
-  bool isProtoClass = JSExportDefinitionWriter::overlaidClasses.find(meta->jsName) != JSExportDefinitionWriter::overlaidClasses.end();
+  bool isProtoClass = JSExportDefinitionWriter::isOverlaidClass(meta->jsName);
 
   if (isProtoClass) {
     metaName = meta->name;
@@ -686,7 +687,7 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
       MethodMeta* method = methodPair.second.second;
 
       if (method->jsName == propertyMeta->jsName) {
-        cerr << "Skipping " << method->jsName << endl;
+        OutputScheduler::err() << "Skipping " << method->jsName << endl;
         skipProperty = true;
         break;
       }
@@ -713,7 +714,7 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
       }
       
       if (meta->nameExistsInSuperclass(propertyMeta->name, Method)) {
-        cerr << "Skipping property that exists as method in " << meta->jsName << " superclass: `" << propertyMeta->name << "`" << endl;
+        OutputScheduler::err() << "Skipping property that exists as method in " << meta->jsName << " superclass: `" << propertyMeta->name << "`" << endl;
         continue;
       }
       
@@ -777,7 +778,7 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
       MethodMeta* method = methodPair.second.second;
       
       if (method->jsName == propertyMeta->jsName) {
-        cerr << "Skipping " << method->jsName << endl;
+        OutputScheduler::err() << "Skipping " << method->jsName << endl;
         skipProperty = true;
         break;
       }
@@ -814,7 +815,7 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
 
     for (PropertyMeta* property : meta->instanceProperties) {
       if (property->jsName == method->jsName) {
-        cerr << "Skipping " << method->jsName << endl;
+        OutputScheduler::err() << "Skipping " << method->jsName << endl;
         skipMethod = true;
         break;
       }
@@ -858,19 +859,19 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
     }
   }
   
-  allNamespaces[meta->module->Name] = true;
-  allClasses[meta->jsName] = true;
+  _namespaces.namespaces[meta->module->Name] = true;
+  _namespaces.classNames[meta->jsName] = true;
   
   out << "}" << endl << endl;
   
   out << "export function " << metaName << parametersString << "(args?: any): " << metaName << parametersString << ";" << endl << endl;
   
   if (containerName != metaName && !isProtoClass) {
-    namespaceClasses[containerName].push_back(out.str());
+    _namespaces.classes[containerName].push_back(out.str());
     return;
   }
   
-  _buffer << out.str();
+  _buffer << out.ref();
 }
 
 // MARK: Visit Protocol
@@ -879,7 +880,7 @@ void DefinitionWriter::visit(ProtocolMeta* meta)
 {
   string metaName = meta->jsName;
   
-  allInterfaces[metaName] = true;
+  _namespaces.interfaces[metaName] = true;
   
   _buffer << "interface " << metaName;
   
@@ -930,7 +931,7 @@ void DefinitionWriter::visit(ProtocolMeta* meta)
     if (method->getFlags(MethodIsInitializer)) {
       continue;
     }
-    if (hiddenMethods.find(method->jsName) != hiddenMethods.end() ) {
+    if (hiddenMethods.contains(method->jsName)) {
       continue;
     }
     
@@ -998,7 +999,7 @@ void DefinitionWriter::visit(EnumMeta* meta)
     enumContainer = renamedName(renamedEnumNameTokens[1]);
   }
 
-  allNamespaces[moduleName] = true;
+  _namespaces.namespaces[moduleName] = true;
   
   if (moduleName == enumContainer) {
     enumContainer = "_container";
@@ -1030,8 +1031,8 @@ void DefinitionWriter::visit(EnumMeta* meta)
 
 void DefinitionWriter::visit(VarMeta* meta)
 {
-  allNamespaces[meta->module->Name] = true;
-  namespaceVars[meta->module->Name].push_back(meta);
+  _namespaces.namespaces[meta->module->Name] = true;
+  _namespaces.vars[meta->module->Name].push_back(meta);
 }
 
 // MARK: Visit Method
@@ -1050,7 +1051,7 @@ void DefinitionWriter::visit(EnumConstantMeta* meta) { }
 
 void DefinitionWriter::visit(StructMeta* meta)
 {
-  allNamespaces[meta->module->Name] = true;
+  _namespaces.namespaces[meta->module->Name] = true;
 }
 
 // MARK: Visit Union
@@ -1062,7 +1063,7 @@ void DefinitionWriter::visit(UnionMeta* meta)
   string members = writeMembers(meta->fields, comment.fields);
   
   if (!members.empty()) {
-    allNamespaces[meta->module->Name] = true;
+    _namespaces.namespaces[meta->module->Name] = true;
     
     _buffer << "// union \n";
     _buffer << "interface " << metaName << " {\n";
@@ -1079,10 +1080,10 @@ void DefinitionWriter::visit(CategoryMeta* meta) { }
 
 void DefinitionWriter::visit(FunctionMeta* meta)
 {
-  allNamespaces[meta->module->Name] = true;
+  _namespaces.namespaces[meta->module->Name] = true;
   
   const clang::FunctionDecl& functionDecl = *clang::dyn_cast<clang::FunctionDecl>(meta->declaration);
-  ostringstream params;
+  EmissionBuffer params;
   
   for (size_t i = 1; i < meta->signature.size(); i++) {
     string name = sanitizeParameterName(functionDecl.getParamDecl(i - 1)->getNameAsString());
@@ -1101,7 +1102,7 @@ void DefinitionWriter::visit(FunctionMeta* meta)
   
   _buffer << "// export function ";
   _buffer << meta->jsName;
-  _buffer << "(" << params.str() << "): ";
+  _buffer << "(" << params.ref() << "): ";
   
   string returnName;
   
@@ -1117,7 +1118,7 @@ void DefinitionWriter::visit(FunctionMeta* meta)
 
 string DefinitionWriter::computeMethodReturnType(const Type* retType, const BaseClassMeta* owner, bool instanceMember)
 {
-  ostringstream output;
+  EmissionBuffer output;
   
   if (retType->is(TypeInstancetype)) {
     output << owner->jsName;
@@ -1133,7 +1134,7 @@ string DefinitionWriter::computeMethodReturnType(const Type* retType, const Base
     //
     // e.g. NSTypesetterControlCharacterAction -> NSTypesetter.NSTypesetterControlCharacterAction
     //
-    if (namespaceEnums[owner->jsName]["_container"][typeStr]) {
+    if (isContainedEnum(owner->jsName, typeStr)) {
       typeStr = owner->jsName + "." + typeStr;
     }
     
@@ -1161,11 +1162,11 @@ string DefinitionWriter::writeMethod(CompoundMemberMap<MethodMeta>::value_type&
   BaseClassMeta* memberOwner = methodPair.second.first;
   MethodMeta* method = methodPair.second.second;
   
-  if (method->getUnavailableInSwift(owner)) {
+  if (MemberLowering::lower(method, owner).unavailableInSwift) {
     return string();
   }
   
-  if (hiddenMethods.find(method->jsName) != hiddenMethods.end()) {
+  if (hiddenMethods.contains(method->jsName)) {
     return string();
   }
   
@@ -1173,7 +1174,7 @@ string DefinitionWriter::writeMethod(CompoundMemberMap<MethodMeta>::value_type&
   bool implementsProtocol = protocols.find(static_cast<ProtocolMeta*>(memberOwner)) != protocols.end();
   bool returnsInstanceType = method->signature[0]->is(TypeInstancetype);
   
-  ostringstream output;
+  EmissionBuffer output;
   
   if (isOwnMethod || implementsProtocol || returnsInstanceType) {
     output << writeMethod(method, owner, canUseThisType);
@@ -1196,7 +1197,7 @@ string DefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, b
   }
   
   if (owner->jsName == "NSWorkspace" && method->jsName == "duplicate") {
-    cout << "";
+    OutputScheduler::out() << "";
   }
   
   transform(parameters.begin(), parameters.end(), back_inserter(parameterNames), [](clang::ParmVarDecl* param) {
@@ -1210,7 +1211,7 @@ string DefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, b
     
     getClosedGenericsIfAny(*method->signature[i+1], paramsGenerics);
     
-    if (method->signature[i+1]->visit(NameRetrieverVisitor::instanceTs) != "") {
+    if (!method->signature[i+1]->dispatch(NameRetrieverVisitor::instanceTs).empty()) {
       string paramType = VueComponentFormatter::current.formatType(*method->signature[i+1], parameters[i]->getType());
       
       if (paramType.substr(0, 4) == "Map<") {
@@ -1239,7 +1240,7 @@ string DefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, b
   if (!paramsGenerics.empty()) {
     for (size_t i = 0; i < paramsGenerics.size(); i++) {
       TypeArgumentType* typeArg = &paramsGenerics[i]->as<TypeArgumentType>();
-      string name = typeArg->visit(NameRetrieverVisitor::instanceTs);
+      llvm::StringRef name = typeArg->dispatch(NameRetrieverVisitor::instanceTs);
       
       if (find(ownerGenerics.begin(), ownerGenerics.end(), name) == ownerGenerics.end())
       {
@@ -1249,12 +1250,13 @@ string DefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, b
     }
   }
   
-  ostringstream output;
+  EmissionBuffer output;
   
   // For some reason, has different params than the method it is overriding
   if (owner->jsName == "NSMenuItemCell") {
-    if (method->builtName() == "drawImageWithFrameInView" ||
-        method->builtName() == "drawTitleWithFrameInView") {
+    const string& builtName = method->builtName();
+    if (builtName == "drawImageWithFrameInView" ||
+        builtName == "drawTitleWithFrameInView") {
       output << "// ";
     }
   }
@@ -1326,7 +1328,7 @@ string DefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, b
     } else if (!paramsGenerics.empty()) {
       output << "<";
       for (size_t i = 0; i < paramsGenerics.size(); i++) {
-        auto name = paramsGenerics[i]->visit(NameRetrieverVisitor::instanceTs);
+        llvm::StringRef name = paramsGenerics[i]->dispatch(NameRetrieverVisitor::instanceTs);
         output << name;
         if (i < paramsGenerics.size() - 1) {
           output << ", ";
@@ -1346,7 +1348,7 @@ string DefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, b
     returnType = "NSFetchRequest<any>";
   }
   
-  bool isProtoClass = JSExportDefinitionWriter::overlaidClasses.find(returnType) != JSExportDefinitionWriter::overlaidClasses.end();
+  bool isProtoClass = JSExportDefinitionWriter::isOverlaidClass(returnType);
   
   // swift overlay classes
   if (isProtoClass) {
@@ -1360,7 +1362,7 @@ string DefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, b
   return output.str();
 }
 
-string DefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta* owner, InterfaceMeta* target, CompoundMemberMap<PropertyMeta> baseClassProperties)
+string DefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta* owner, InterfaceMeta* target, const CompoundMemberMap<PropertyMeta>& baseClassProperties)
 {
   bool optOutTypeChecking = false;
   auto result = baseClassProperties.find(propertyMeta->name);
@@ -1368,7 +1370,7 @@ string DefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta
     optOutTypeChecking = result->second.second->getter->signature[0] != propertyMeta->getter->signature[0];
   }
   
-  if (propertyMeta->getUnavailableInSwift(owner)) {
+  if (MemberLowering::lower(propertyMeta, owner).unavailableInSwift) {
     return "";
   }
   
@@ -1389,13 +1391,13 @@ string DefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta
 
 string DefinitionWriter::writeProperty(PropertyMeta* meta, BaseClassMeta* owner, bool optOutTypeChecking)
 {
-  ostringstream output;
+  EmissionBuffer output;
   
-  if (hiddenMethods.find(meta->jsName) != hiddenMethods.end()) {
+  if (hiddenMethods.contains(meta->jsName)) {
     return string();
   }
   
-  if (meta->getUnavailableInSwift(owner)) {
+  if (MemberLowering::lower(meta, owner).unavailableInSwift) {
     output << "  // unavailableInSwift ";
   }
   
@@ -1429,7 +1431,7 @@ string DefinitionWriter::writeProperty(PropertyMeta* meta, BaseClassMeta* owner,
   if (meta->setter && !meta->setter->jsName.empty()) {
     string setterName = meta->setter->name;
     if (setterName == "setQueryItems") {
-      cout << "";
+      OutputScheduler::out() << "";
     }
     setterName.pop_back();
     
@@ -1454,30 +1456,26 @@ string DefinitionWriter::writeMembers(const vector<RecordField>& fields, vector<
   return members;
 }
 
-string DefinitionWriter::writeExports() {
-  ostringstream output;
+string DefinitionWriter::writeExports(const string& moduleName) {
+  EmissionBuffer output;
   
-  for (auto& namespaceView : namespaceViews) {
-    output << "export var " << namespaceView->shortName() << " = " << namespaceView->jsName << "\n\n";
+  if (moduleName.empty()) {
+    for (auto& namespaceView : namespaceViews) {
+      output << "export var " << namespaceView->shortName() << " = " << namespaceView->jsName << "\n\n";
+    }
   }
 
   map<string, bool> writtenExports = {};
+  const map<string, bool>& namespaceRecords = moduleName.empty() ? allNamespaces : moduleNamespaces[moduleName];
 
   output << "export {\n";
   
   size_t i = 1;
   
-  for (const auto& namespaceRecord : allNamespaces) {
+  for (const auto& namespaceRecord : namespaceRecords) {
     i++;
     
-    string namespaceName = renamedName(namespaceRecord.first);
-    
-    vector<string> namespaceNameTokens;
-    StringUtils::split(namespaceName, '.', back_inserter(namespaceNameTokens));
-    
-    if (namespaceNameTokens.size() == 2) {
-      namespaceName = namespaceNameTokens[0];
-    }
+    string namespaceName = namespaceNameOf(namespaceRecord.first);
 
     bool hasDefinedEnums = false;
     
@@ -1530,7 +1528,8 @@ string DefinitionWriter::writeExports() {
       output << "  " << namespaceName;
     }
     
-    if (i < allNamespaces.size() - 2) {
+    // A trailing comma is fine in the export list of a single framework
+    if (!moduleName.empty() || i < allNamespaces.size() - 2) {
       output << ",";
     }
     
@@ -1539,40 +1538,31 @@ string DefinitionWriter::writeExports() {
   
   output << "};\n";
   
-  namespaceClasses.empty();
-  namespaceVars.empty();
-  namespaceTypealiases.empty();
-  allClasses.empty();
-  allInterfaces.empty();
-  
+  return output.str();
+}
+
+void DefinitionWriter::clearNamespaces()
+{
   namespaceClasses = {};
   namespaceVars = {};
   namespaceTypealiases = {};
   allClasses = {};
   allInterfaces = {};
-  
-  return output.str();
 }
 
 // MARK: - Write Namespaces
-string DefinitionWriter::writeNamespaces(bool writeToClasses)
+string DefinitionWriter::writeNamespaces(bool writeToClasses, const string& moduleName)
 {
   populateTypealiases();
   
-  ostringstream output;
+  EmissionBuffer output;
 
   map<string, bool> writtenEnums = {};
   map<string, bool> writtenNamespaces = {};
+  const map<string, bool>& namespaceRecords = moduleName.empty() ? allNamespaces : moduleNamespaces[moduleName];
 
-  for (const auto& namespaceRecord : allNamespaces) {
-    string namespaceName = renamedName(namespaceRecord.first);
-
-    vector<string> namespaceNameTokens;
-    StringUtils::split(namespaceName, '.', back_inserter(namespaceNameTokens));
-    
-    if (namespaceNameTokens.size() == 2) {
-      namespaceName = namespaceNameTokens[0];
-    }
+  for (const auto& namespaceRecord : namespaceRecords) {
+    string namespaceName = namespaceNameOf(namespaceRecord.first);
 
     bool hasDecls = namespaceEnums[namespaceName].size() ||
       namespaceClasses[namespaceName].size();
@@ -1849,11 +1839,8 @@ string DefinitionWriter::writeNamespaces(bool writeToClasses)
   return output.str();
 }
 
-string DefinitionWriter::visitAll()
+void DefinitionWriter::registerEnums()
 {
-  _buffer.clear();
-  _importedModules.clear();
-  
   // Decorate bridged classes with POJO of enum values,
   // so that they are available at runtime and don't get
   // clobbered when javascriptcore bridges these classes.
@@ -1863,23 +1850,51 @@ string DefinitionWriter::visitAll()
     }
   }
   
-  _buffer.clear();
-  
   for (::Meta::Meta* meta : _module.second) {
     if (meta->is(Enum)) {
       meta->visit(this);
     }
   }
+}
+
+string DefinitionWriter::visitAll()
+{
+  _buffer.clear();
+  _importedModules.clear();
   
   for (::Meta::Meta* meta : _module.second) {
     if (!meta->is(Enum)) {
-      if (JSExportDefinitionWriter::hiddenClasses.find(meta->jsName) == JSExportDefinitionWriter::hiddenClasses.end()) {
+      if (!ExportedClasses::isHidden(meta->jsName)) {
         meta->visit(this);
       }
     }
   }
   
-  return _buffer.str();
+  // The caller streams the declarations to the file, the writer doesn't keep a second copy of them
+  return _buffer.take();
+}
+
+void DefinitionWriter::commitNamespaces()
+{
+  for (auto& vars : _namespaces.vars) {
+    vector<VarMeta*>& allVars = namespaceVars[vars.first];
+    allVars.insert(allVars.end(), vars.second.begin(), vars.second.end());
+  }
+  
+  for (auto& classes : _namespaces.classes) {
+    vector<string>& allContainerClasses = namespaceClasses[classes.first];
+    move(classes.second.begin(), classes.second.end(), back_inserter(allContainerClasses));
+  }
+  
+  allNamespaces.insert(_namespaces.namespaces.begin(), _namespaces.namespaces.end());
+  for (auto& namespaceRecord : _namespaces.namespaces) {
+    const string& owner = namespaceOwners.emplace(namespaceNameOf(namespaceRecord.first), _module.first->Name).first->second;
+    moduleNamespaces[owner][namespaceRecord.first] = true;
+  }
+  allClasses.insert(_namespaces.classNames.begin(), _namespaces.classNames.end());
+  allInterfaces.insert(_namespaces.interfaces.begin(), _namespaces.interfaces.end());
+  
+  _namespaces = NamespaceRecords();
 }
 
 }
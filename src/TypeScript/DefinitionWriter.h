@@ -1,9 +1,10 @@
 #pragma once
 
 #include "DocSetManager.h"
+#include "EmissionBuffer.h"
+#include "MemberTable.h"
 #include "Meta/MetaEntities.h"
 #include <Meta/TypeFactory.h>
-#include <sstream>
 #include <string>
 #include <unordered_set>
 
@@ -17,11 +18,27 @@ public:
     {
     }
 
+    // Registers the module's enums for the namespaces. Has to be called for every module,
+    // in module order, before visitAll() is called for any of them.
+    void registerEnums();
+
+    // Writes the module's declarations. Writers of different modules can run in parallel,
+    // as they only read the state which they share.
     std::string visitAll();
+
+    // Hands what visitAll() collected for the namespaces to writeNamespaces() and
+    // writeExports(). Has to be called in module order.
+    void commitNamespaces();
     
-    static std::string writeNamespaces(bool writeToClasses = false);
+    // Writes the namespaces, or only those written to the declaration file of moduleName
+    // when the declarations are split per framework. A namespace is written to the file
+    // of the first module declaring it.
+    static std::string writeNamespaces(bool writeToClasses = false, const std::string& moduleName = "");
 
-    static std::string writeExports();
+    static std::string writeExports(const std::string& moduleName = "");
+
+    // Releases what was collected for the namespaces, once they are all written.
+    static void clearNamespaces();
 
     static bool applyManualChanges;
   
@@ -49,16 +66,18 @@ public:
 
 private:
     template <class Member>
-    using CompoundMemberMap = std::map<std::string, std::pair<Meta::BaseClassMeta*, Member*> >;
+    using CompoundMemberMap = MemberTable<Meta::BaseClassMeta, Member>;
 
-    std::string writeMembers(const std::vector<Meta::RecordField>& fields, std::vector<TSComment> fieldsComments);
-    std::string writeProperty(Meta::PropertyMeta* meta, Meta::BaseClassMeta* owner, Meta::InterfaceMeta* target, CompoundMemberMap<Meta::PropertyMeta> compoundProperties);
+    struct NamespaceRecords {
+        std::map<std::string, std::vector<Meta::VarMeta*> > vars;
+        std::map<std::string, std::vector<std::string> > classes;
+        std::map<std::string, bool> namespaces;
+        std::map<std::string, bool> classNames;
+        std::map<std::string, bool> interfaces;
+    };
 
-    static void getInheritedMembersRecursive(Meta::InterfaceMeta* interface,
-        CompoundMemberMap<Meta::MethodMeta>* staticMethods,
-        CompoundMemberMap<Meta::MethodMeta>* instanceMethods,
-        CompoundMemberMap<Meta::PropertyMeta>* staticProperties,
-        CompoundMemberMap<Meta::PropertyMeta>* instanceProperties);
+    std::string writeMembers(const std::vector<Meta::RecordField>& fields, std::vector<TSComment> fieldsComments);
+    std::string writeProperty(Meta::PropertyMeta* meta, Meta::BaseClassMeta* owner, Meta::InterfaceMeta* target, const CompoundMemberMap<Meta::PropertyMeta>& compoundProperties);
 
     static void getProtocolMembersRecursive(Meta::ProtocolMeta* protocol,
         CompoundMemberMap<Meta::MethodMeta>* staticMethods,
@@ -91,6 +110,7 @@ private:
     Meta::TypeFactory& _typeFactory;
     DocSetManager _docSet;
     std::unordered_set<std::string> _importedModules;
-    std::ostringstream _buffer;
+    NamespaceRecords _namespaces;
+    EmissionBuffer _buffer;
 };
 }
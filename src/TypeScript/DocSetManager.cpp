@@ -3,9 +3,15 @@
 //
 
 #include "DocSetManager.h"
-#include <libxml/xpath.h>
+#include "DocTokenReader.h"
+#include "Utils/ShardedMemo.h"
+#include <fstream>
+#include <iostream>
+#include <libxml/parser.h>
+#include <llvm/Support/Chrono.h>
+#include <llvm/Support/FileSystem.h>
 #include <sstream>
-#include <unistd.h>
+#include <unordered_set>
 
 namespace {
 using namespace std;
@@ -44,44 +50,109 @@ void findAndReplaceIn(string& str, string searchFor, string replaceBy)
     };
 }
 
-xmlNodeSetPtr all(const xmlChar* xpath, xmlDocPtr doc, xmlXPathObjectPtr& result)
+TypeScript::TSComment readComment(const string& path, Meta::MetaType type)
 {
-    xmlXPathContextPtr context = xmlXPathNewContext(doc);
-    result = xmlXPathEvalExpression(xpath, context);
-    xmlXPathFreeContext(context);
-    if (xmlXPathNodeSetIsEmpty(result->nodesetval)) {
-        xmlXPathFreeObject(result);
-        result = nullptr;
-        return NULL;
+    TypeScript::TSComment comment;
+    TypeScript::DocToken token;
+    if (!TypeScript::DocTokenReader::read(path, token)) {
+        return comment;
     }
-    return result->nodesetval;
+
+    comment.description = trim(token.abstract);
+
+    switch (type) {
+    case Meta::MetaType::Method:
+    case Meta::MetaType::Function: {
+        vector<string>& paramNames = token.parameterTerms;
+        if (paramNames.size() > 0) {
+            vector<string>& paramDescs = token.parameterDiscussions;
+            assert(paramNames.size() == paramDescs.size());
+
+            for (size_t i = 0; i < paramNames.size(); i++) {
+                comment.params.push_back(pair<string, string>(paramNames[i], trim(paramDescs[i])));
+            }
+        }
+        break;
+    }
+    case Meta::MetaType::Struct:
+    case Meta::MetaType::Union: {
+        for (string& fieldDesc : token.fieldDiscussions) {
+            TypeScript::TSComment fieldComment;
+            fieldComment.description = trim(fieldDesc);
+            comment.fields.push_back(fieldComment);
+        }
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+
+    return comment;
+}
+
+// Strings in the comments cache are written as `<length>:<bytes>`, so they may contain any character
+void writeCachedString(ostream& out, const string& value)
+{
+    out << value.size() << ':' << value;
 }
 
-xmlNodePtr first(const xmlChar* xpath, xmlDocPtr doc, xmlXPathObjectPtr& result)
+bool readCachedString(istream& in, string& value)
 {
-    xmlNodeSetPtr nodes = all(xpath, doc, result);
-    if (nodes && nodes->nodeNr > 0)
-        return nodes->nodeTab[0];
-    return nullptr;
+    size_t length;
+    if (!(in >> length) || in.get() != ':') {
+        return false;
+    }
+    value.resize(length);
+    return length == 0 || in.read(&value[0], length);
 }
 
-string innerTextOf(xmlNodePtr xmlNode, xmlDocPtr doc)
+void writeCachedComment(ostream& out, const TypeScript::TSComment& comment)
 {
-    char* innerText = reinterpret_cast<char*>(xmlNodeGetContent(xmlNode));
-    string innerStr(innerText);
-    xmlFree(innerText);
-    return innerStr;
+    writeCachedString(out, comment.description);
+    out << comment.params.size() << ' ';
+    for (const pair<string, string>& param : comment.params) {
+        writeCachedString(out, param.first);
+        writeCachedString(out, param.second);
+    }
+    out << comment.fields.size() << ' ';
+    for (const TypeScript::TSComment& field : comment.fields) {
+        writeCachedComment(out, field);
+    }
 }
 
-vector<string> innerTextOf(xmlNodeSetPtr xmlNodes, xmlDocPtr doc)
+bool readCachedComment(istream& in, TypeScript::TSComment& comment)
 {
-    vector<string> result;
-    if (xmlNodes != nullptr) {
-        for (int i = 0; i < xmlNodes->nodeNr; ++i) {
-            result.push_back(innerTextOf(xmlNodes->nodeTab[i], doc));
+    size_t paramsCount, fieldsCount;
+    if (!readCachedString(in, comment.description) || !(in >> paramsCount)) {
+        return false;
+    }
+    comment.params.resize(paramsCount);
+    for (pair<string, string>& param : comment.params) {
+        if (!readCachedString(in, param.first) || !readCachedString(in, param.second)) {
+            return false;
         }
     }
-    return result;
+    if (!(in >> fieldsCount)) {
+        return false;
+    }
+    comment.fields.resize(fieldsCount);
+    for (TypeScript::TSComment& field : comment.fields) {
+        if (!readCachedComment(in, field)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Identifies the docset the comments cache was written for
+string docSetStamp(const string& docsetPath)
+{
+    llvm::sys::fs::file_status status;
+    if (llvm::sys::fs::status(docsetPath, status)) {
+        return string();
+    }
+    return docsetPath + "@" + to_string(llvm::sys::toTimeT(status.getLastModificationTime()));
 }
 }
 
@@ -108,127 +179,193 @@ string TSComment::toString(string linePrefix)
     return result.str();
 }
 
-TSComment DocSetManager::getCommentFor(Meta::Meta* meta, Meta::Meta* parent)
+struct DocSetManager::DocSet {
+    string tokensPath;
+
+    // The XML files in the Tokens folder, relative to it
+    once_flag indexed;
+    unordered_set<string> documents;
+
+    // Keyed by the symbol, symbols without documentation have an empty comment. The comments read from the
+    // docset during this run are the ones the memo computed
+    ShardedMemo<string, TSComment> comments;
+    size_t cachedCount = 0;
+
+    string cachePath;
+    string stamp;
+};
+
+mutex DocSetManager::docSetsMutex;
+unordered_map<string, unique_ptr<DocSetManager::DocSet> > DocSetManager::docSets;
+
+DocSetManager::DocSetManager(string docsetPath)
+    : _docSet(docsetPath.empty() ? nullptr : docSetFor(docsetPath))
 {
-    return (parent == nullptr) ? getCommentFor(meta->name, meta->type) : getCommentFor(meta->name, meta->type, parent->name, parent->type);
 }
 
-TSComment DocSetManager::getCommentFor(string name, Meta::MetaType type, string parentName, Meta::MetaType parentType)
+DocSetManager::DocSet* DocSetManager::docSetFor(const string& docsetPath)
+{
+    lock_guard<mutex> lock(docSetsMutex);
+    unique_ptr<DocSet>& docSet = docSets[docsetPath];
+    if (!docSet) {
+        docSet.reset(new DocSet());
+        docSet->tokensPath = docsetPath + "/Contents/Resources/Tokens";
+    }
+    return docSet.get();
+}
+
+void DocSetManager::initialize(const string& docsetPath, const string& cachePath)
 {
-    xmlDocPtr doc = getXmlDocFileFor(name, type, parentName, parentType);
+    xmlInitParser();
+
+    if (docsetPath.empty() || cachePath.empty()) {
+        return;
+    }
+
+    DocSet* docSet = docSetFor(docsetPath);
+    docSet->cachePath = cachePath;
+    docSet->stamp = docSetStamp(docsetPath);
+
+    ifstream cache(cachePath, ios::binary);
+    string stamp;
+    if (!cache || !readCachedString(cache, stamp) || stamp != docSet->stamp) {
+        return;
+    }
 
+    string key;
     TSComment comment;
-    if (doc) {
-        xmlXPathObjectPtr abstractNodeResult = nullptr;
-        xmlNodePtr abstractNode = first(reinterpret_cast<const xmlChar*>("/*/Abstract"), doc, abstractNodeResult);
-        if (abstractNode != nullptr) {
-            string description = innerTextOf(abstractNode, doc);
-            comment.description = trim(description);
+    while (readCachedString(cache, key) && readCachedComment(cache, comment)) {
+        docSet->comments.insert(key, std::move(comment));
+        comment = TSComment();
+    }
+    docSet->cachedCount = docSet->comments.size();
+}
+
+void DocSetManager::saveCache()
+{
+    lock_guard<mutex> lock(docSetsMutex);
+    for (auto& docSetPair : docSets) {
+        DocSet& docSet = *docSetPair.second;
+        size_t parsedCount = docSet.comments.computed();
+        if (parsedCount == 0 && docSet.cachedCount == 0) {
+            continue;
         }
+        cout << "[DocSet] " << docSet.cachedCount << " comments from the cache, " << parsedCount << " read from the docset." << endl;
 
-        switch (type) {
-        case Meta::MetaType::Method:
-        case Meta::MetaType::Function: {
-            xmlXPathObjectPtr termNodesResult = nullptr;
-            vector<string> paramNames = innerTextOf(all(reinterpret_cast<const xmlChar*>("/*/Parameters/Parameter/Term"), doc, termNodesResult), doc);
-            if (paramNames.size() > 0) {
-                xmlXPathObjectPtr discussionNodesResult = nullptr;
-                vector<string> paramDescs = innerTextOf(all(reinterpret_cast<const xmlChar*>("/*/Parameters/Parameter/Discussion"), doc, discussionNodesResult), doc);
-                assert(paramNames.size() == paramDescs.size());
-
-                for (size_t i = 0; i < paramNames.size(); i++) {
-                    comment.params.push_back(pair<string, string>(paramNames[i], trim(paramDescs[i])));
-                }
-                xmlXPathFreeObject(discussionNodesResult);
-            }
-            xmlXPathFreeObject(termNodesResult);
-            break;
+        if (docSet.cachePath.empty() || parsedCount == 0 || docSet.stamp.empty()) {
+            continue;
         }
-        case Meta::MetaType::Struct:
-        case Meta::MetaType::Union: {
-            xmlXPathObjectPtr discussionNodesResult = nullptr;
-            vector<string> fieldsDescs = innerTextOf(all(reinterpret_cast<const xmlChar*>("/*/Fields/Field/Discussion"), doc, discussionNodesResult), doc);
-            if (fieldsDescs.size() > 0) {
-                for (size_t i = 0; i < fieldsDescs.size(); i++) {
-                    TSComment fieldComment;
-                    fieldComment.description = trim(fieldsDescs[i]);
-                    comment.fields.push_back(fieldComment);
-                }
+
+        string temporaryPath = docSet.cachePath + ".tmp";
+        {
+            ofstream cache(temporaryPath, ios::binary | ios::trunc);
+            writeCachedString(cache, docSet.stamp);
+            docSet.comments.forEach([&cache](const string& key, const TSComment& comment) {
+                writeCachedString(cache, key);
+                writeCachedComment(cache, comment);
+            });
+            if (!cache) {
+                cerr << "Could not write the docset cache " << docSet.cachePath << endl;
+                continue;
             }
-            xmlXPathFreeObject(discussionNodesResult);
-            break;
         }
-        default: {
-            break;
+        if (error_code error = llvm::sys::fs::rename(temporaryPath, docSet.cachePath)) {
+            cerr << docSet.cachePath << ": " << error.message() << endl;
         }
-        }
-        xmlXPathFreeObject(abstractNodeResult);
     }
+}
 
-    xmlFreeDoc(doc);
-    return comment;
+TSComment DocSetManager::getCommentFor(Meta::Meta* meta, Meta::Meta* parent)
+{
+    return (parent == nullptr) ? getCommentFor(meta->name, meta->type) : getCommentFor(meta->name, meta->type, parent->name, parent->type);
 }
 
-xmlDocPtr DocSetManager::getXmlDocFileFor(string name, Meta::MetaType type, string parentName, Meta::MetaType parentType)
+TSComment DocSetManager::getCommentFor(string name, Meta::MetaType type, string parentName, Meta::MetaType parentType)
+{
+    if (!_docSet) {
+        return TSComment();
+    }
+
+    string key = to_string(static_cast<int>(type)) + ":" + to_string(static_cast<int>(parentType)) + ":" + parentName + ":" + name;
+
+    DocSet& docSet = *_docSet;
+    // Parsed without holding a lock, if two writers ask for the same symbol both read the same comment
+    return docSet.comments.get(key, [&]() {
+        call_once(docSet.indexed, [&docSet]() {
+            error_code error;
+            for (llvm::sys::fs::recursive_directory_iterator it(docSet.tokensPath, error), end; it != end && !error; it.increment(error)) {
+                const string& path = it->path();
+                if (path.size() > docSet.tokensPath.size() + 4 && path.compare(path.size() - 4, 4, ".xml") == 0) {
+                    docSet.documents.insert(path.substr(docSet.tokensPath.size() + 1));
+                }
+            }
+        });
+
+        TSComment comment;
+        for (const string& candidate : xmlPathCandidatesFor(name, type, parentName, parentType)) {
+            if (docSet.documents.find(candidate) != docSet.documents.end()) {
+                comment = readComment(docSet.tokensPath + "/" + candidate, type);
+                break;
+            }
+        }
+        return comment;
+    });
+}
+
+vector<string> DocSetManager::xmlPathCandidatesFor(const string& name, Meta::MetaType type, const string& parentName, Meta::MetaType parentType)
 {
     string parent = (parentName == "") ? "-" : parentName;
     vector<string> xmlPathCandidates;
     switch (type) {
     case Meta::MetaType::Struct: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/tdef/" + parent + "/" + name + ".xml");
-        xmlPathCandidates.push_back(this->tokensPath + "/c/tag/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/tdef/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/tag/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Function: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/func/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/func/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Enum: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/tdef/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/tdef/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::EnumConstant: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/econst/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/econst/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Var: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/data/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/data/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Interface: {
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/cl/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/cl/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Protocol: {
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/intf/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/intf/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Category: {
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/cat/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/cat/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Method: {
         string type1 = (parentType == Meta::MetaType::Interface) ? "instm" : "intfm";
         string type2 = (parentType == Meta::MetaType::Interface) ? "clm" : "intfcm";
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/" + type1 + "/" + parent + "/" + name + ".xml");
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/" + type2 + "/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/" + type1 + "/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/" + type2 + "/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Property: {
         string type = (parentType == Meta::MetaType::Interface) ? "instp" : "intfp";
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/" + type + "/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/" + type + "/" + parent + "/" + name + ".xml");
         break;
     }
     default: {
         break;
     }
     }
-
-    for (string& path : xmlPathCandidates) {
-        if (access(path.c_str(), F_OK) == 0) {
-            return xmlReadFile(path.c_str(), nullptr, 0);
-        }
-    }
-    return nullptr;
+    return xmlPathCandidates;
 }
 }
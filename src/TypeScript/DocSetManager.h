@@ -6,8 +6,9 @@
 #define METADATAGENERATOR_DOCSETPARSER_H
 
 #include <Meta/MetaEntities.h>
-
-struct _xmlDoc;
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace Meta {
 class Meta;
@@ -41,14 +42,14 @@ struct TSComment {
 /*
  * \class DocSetManager
  * \brief The DocSetManager is responsible for parsing and retrieving documentation from .docset packages. It parses the XML files in the .docset and generates TypeScript comments from them.
+ *
+ * All managers of the same docset share its index and comments, so every writer reads a symbol's documentation from the
+ * comment the first writer asking for it parsed. The XML files are listed once, when the first symbol isn't found in the
+ * comments, and are parsed by the writers running in parallel without holding a lock.
  */
 class DocSetManager {
 public:
-    DocSetManager(std::string docsetPath)
-        : docsetPath(docsetPath)
-        , tokensPath(docsetPath + "/Contents/Resources/Tokens")
-    {
-    }
+    DocSetManager(std::string docsetPath);
 
     /*
      * \brief Retrieves a TypeScript comment for a given symbol. If the symbol is a member (e.g. method or property) a parent must be supplied, too.
@@ -59,18 +60,36 @@ public:
 
     TSComment getCommentFor(std::string name, Meta::MetaType type, std::string parentName = "", Meta::MetaType parentType = Meta::MetaType::Undefined);
 
+    /*
+     * \brief Initializes libxml2. Has to be called on the main thread before documentation is read by writers running in parallel.
+     * \param docsetPath The docset whose comments are cached.
+     * \param cachePath A file keeping the comments between runs. It is only used while it was written for the same docset path and modification time.
+     */
+    static void initialize(const std::string& docsetPath = "", const std::string& cachePath = "");
+
+    /*
+     * \brief Writes the comments read during this run to the cache file passed to initialize(), if any were added.
+     */
+    static void saveCache();
+
 private:
+    struct DocSet;
+
+    static DocSet* docSetFor(const std::string& docsetPath);
+
     /*
-     * \brief Tries to find the location and parses the XML documentation file for a symbol with the given name and type. Null is returned if unable to find a doc file.
+     * \brief Returns the paths, relative to the Tokens folder, at which the XML documentation file for a symbol with the given name and type may be.
      * \param name The name of the symbol.
      * \param type The type of the symbol. Depending on the type, different foldeers will be examined.
      * \param parentName If the symbol is method or property, a parent (the containing Interface or Protocol) must be passed, too, in order to find the correct XML file location.
      * \param parentType The type of the parent symbol.
      */
-    _xmlDoc* getXmlDocFileFor(std::string name, Meta::MetaType type, std::string parentName = "", Meta::MetaType parentType = Meta::MetaType::Undefined);
+    static std::vector<std::string> xmlPathCandidatesFor(const std::string& name, Meta::MetaType type, const std::string& parentName, Meta::MetaType parentType);
+
+    static std::mutex docSetsMutex;
+    static std::unordered_map<std::string, std::unique_ptr<DocSet> > docSets;
 
-    std::string docsetPath;
-    std::string tokensPath;
+    DocSet* _docSet;
 };
 }
 
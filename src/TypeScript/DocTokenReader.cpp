@@ -0,0 +1,95 @@
+#include "DocTokenReader.h"
+#include <cstring>
+#include <libxml/xmlreader.h>
+
+namespace TypeScript {
+using namespace std;
+
+static bool isNamed(const xmlChar* name, const char* expected)
+{
+    return strcmp(reinterpret_cast<const char*>(name), expected) == 0;
+}
+
+bool DocTokenReader::read(const string& path, DocToken& token)
+{
+    xmlTextReaderPtr reader = xmlReaderForFile(path.c_str(), nullptr, 0);
+    if (!reader) {
+        return false;
+    }
+
+    // The names of the open elements below the root, e.g. Parameters and Parameter inside a Term
+    vector<const xmlChar*> openElements;
+    bool hasAbstract = false;
+    // The string the text of the current element goes to, and the depth of that element
+    string* text = nullptr;
+    int textDepth = -1;
+
+    int status;
+    while ((status = xmlTextReaderRead(reader)) == 1) {
+        int depth = xmlTextReaderDepth(reader);
+
+        switch (xmlTextReaderNodeType(reader)) {
+        case XML_READER_TYPE_ELEMENT: {
+            // Interned in the reader's dictionary, so the pointers stay valid while it's open
+            const xmlChar* name = xmlTextReaderConstName(reader);
+            if (depth == 0) {
+                break;
+            }
+            openElements.resize(depth - 1);
+            openElements.push_back(name);
+
+            if (text) {
+                break;
+            }
+            string* target = nullptr;
+            if (depth == 1 && !hasAbstract && isNamed(name, "Abstract")) {
+                hasAbstract = true;
+                target = &token.abstract;
+            } else if (depth == 3 && isNamed(openElements[0], "Parameters") && isNamed(openElements[1], "Parameter")) {
+                if (isNamed(name, "Term")) {
+                    token.parameterTerms.emplace_back();
+                    target = &token.parameterTerms.back();
+                } else if (isNamed(name, "Discussion")) {
+                    token.parameterDiscussions.emplace_back();
+                    target = &token.parameterDiscussions.back();
+                }
+            } else if (depth == 3 && isNamed(openElements[0], "Fields") && isNamed(openElements[1], "Field") && isNamed(name, "Discussion")) {
+                token.fieldDiscussions.emplace_back();
+                target = &token.fieldDiscussions.back();
+            }
+
+            if (target && !xmlTextReaderIsEmptyElement(reader)) {
+                text = target;
+                textDepth = depth;
+            }
+            break;
+        }
+        case XML_READER_TYPE_END_ELEMENT:
+            if (text && depth == textDepth) {
+                text = nullptr;
+            }
+            break;
+        case XML_READER_TYPE_TEXT:
+        case XML_READER_TYPE_CDATA:
+        case XML_READER_TYPE_WHITESPACE:
+        case XML_READER_TYPE_SIGNIFICANT_WHITESPACE:
+            if (text) {
+                if (const xmlChar* value = xmlTextReaderConstValue(reader)) {
+                    text->append(reinterpret_cast<const char*>(value));
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    xmlFreeTextReader(reader);
+
+    if (status != 0) {
+        token = DocToken();
+        return false;
+    }
+    return true;
+}
+}
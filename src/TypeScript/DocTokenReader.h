@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace TypeScript {
+/*
+ * \struct DocToken
+ * \brief The text of the parts of a docset token file which end up in comments, untrimmed.
+ */
+struct DocToken {
+    // /*/Abstract, only the first one
+    std::string abstract;
+    // /*/Parameters/Parameter/Term
+    std::vector<std::string> parameterTerms;
+    // /*/Parameters/Parameter/Discussion
+    std::vector<std::string> parameterDiscussions;
+    // /*/Fields/Field/Discussion
+    std::vector<std::string> fieldDiscussions;
+};
+
+/*
+ * \class DocTokenReader
+ * \brief Reads a docset token XML file in one forward pass with xmlTextReader, without building its tree.
+ *
+ * The text of an element is collected like xmlNodeGetContent() does, from all the text and CDATA below it.
+ */
+class DocTokenReader {
+public:
+    /*
+     * \brief Returns false if the file can't be read or isn't well-formed, the token is left empty then.
+     */
+    static bool read(const std::string& path, DocToken& token);
+};
+}
@@ -0,0 +1,36 @@
+#include "EmissionBuffer.h"
+#include <vector>
+
+namespace TypeScript {
+using namespace std;
+
+// Storage given back by the destroyed buffers of a thread, so taking and giving it back needs no lock
+static thread_local vector<string> pool;
+static const size_t initialCapacity = 4096;
+static const size_t maxPooled = 32;
+
+EmissionBuffer::EmissionBuffer()
+{
+    if (!pool.empty()) {
+        _storage = move(pool.back());
+        pool.pop_back();
+    } else {
+        _storage.reserve(initialCapacity);
+    }
+}
+
+EmissionBuffer::~EmissionBuffer()
+{
+    if (pool.size() < maxPooled && _storage.capacity() >= initialCapacity) {
+        _storage.clear();
+        pool.push_back(move(_storage));
+    }
+}
+
+string EmissionBuffer::take()
+{
+    string text = move(_storage);
+    _storage.clear();
+    return text;
+}
+}
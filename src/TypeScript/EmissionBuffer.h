@@ -0,0 +1,107 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace TypeScript {
+/*
+ * \class EmissionBuffer
+ * \brief The text a writer builds up for a member, a meta or a module, appended to like an output stream.
+ *
+ * The storage is taken from a pool of the current thread and given back with its capacity when the buffer
+ * is destroyed, so the buffers of the next metas and modules written on that thread don't grow from scratch.
+ */
+class EmissionBuffer {
+public:
+    EmissionBuffer();
+
+    ~EmissionBuffer();
+
+    EmissionBuffer(const EmissionBuffer&) = delete;
+    EmissionBuffer& operator=(const EmissionBuffer&) = delete;
+
+    EmissionBuffer& operator<<(llvm::StringRef text)
+    {
+        _storage.append(text.data(), text.size());
+        return *this;
+    }
+
+    EmissionBuffer& operator<<(const std::string& text)
+    {
+        _storage.append(text);
+        return *this;
+    }
+
+    EmissionBuffer& operator<<(const char* text)
+    {
+        _storage.append(text);
+        return *this;
+    }
+
+    EmissionBuffer& operator<<(char c)
+    {
+        _storage.push_back(c);
+        return *this;
+    }
+
+    template <class Integer>
+    typename std::enable_if<std::is_integral<Integer>::value, EmissionBuffer&>::type operator<<(Integer value)
+    {
+        _storage.append(std::to_string(value));
+        return *this;
+    }
+
+    /*
+     * \brief Appends a new line for std::endl, there is nothing to flush.
+     */
+    EmissionBuffer& operator<<(std::ostream& (*)(std::ostream&))
+    {
+        _storage.push_back('\n');
+        return *this;
+    }
+
+    /*
+     * \brief A copy of the text, like std::ostringstream::str().
+     */
+    std::string str() const
+    {
+        return _storage;
+    }
+
+    /*
+     * \brief The text without copying it, valid until the buffer is changed.
+     */
+    llvm::StringRef ref() const
+    {
+        return _storage;
+    }
+
+    /*
+     * \brief Moves the text out of the buffer, which is empty afterwards.
+     */
+    std::string take();
+
+    bool empty() const
+    {
+        return _storage.empty();
+    }
+
+    size_t size() const
+    {
+        return _storage.size();
+    }
+
+    /*
+     * \brief Empties the buffer and keeps its capacity for the next meta.
+     */
+    void clear()
+    {
+        _storage.clear();
+    }
+
+private:
+    std::string _storage;
+};
+}
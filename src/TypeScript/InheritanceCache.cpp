@@ -0,0 +1,77 @@
+#include "InheritanceCache.h"
+#include <algorithm>
+#include <cassert>
+
+namespace TypeScript {
+using namespace Meta;
+using namespace std;
+
+unordered_map<InterfaceMeta*, InheritanceCache::Tables> InheritanceCache::tables;
+
+void InheritanceCache::build(const vector<pair<clang::Module*, vector<Meta::Meta*> > >& metasByModules)
+{
+    for (const pair<clang::Module*, vector<Meta::Meta*> >& modulePair : metasByModules) {
+        for (Meta::Meta* meta : modulePair.second) {
+            if (meta->is(MetaType::Interface)) {
+                tablesFor(&meta->as<InterfaceMeta>());
+            }
+        }
+    }
+}
+
+const InheritanceCache::MethodTable& InheritanceCache::inheritedStaticMethods(InterfaceMeta* interface, Key key)
+{
+    // The tables are only read once build() has run, so the writers don't need to lock them
+    auto it = tables.find(interface);
+    assert(it != tables.end());
+    const Tables& interfaceTables = it->second;
+    return key == Key::Name ? interfaceTables.staticMethodsByName : interfaceTables.staticMethodsByJsName;
+}
+
+const InheritanceCache::Tables& InheritanceCache::tablesFor(InterfaceMeta* interface)
+{
+    auto it = tables.find(interface);
+    if (it != tables.end()) {
+        return it->second;
+    }
+
+    Tables interfaceTables;
+    InterfaceMeta* base = interface->base;
+    if (base) {
+        // The superclass's own methods come first, then those of its protocols and then what it inherits itself
+        for (MethodMeta* method : base->staticMethods) {
+            interfaceTables.staticMethodsByName.emplace(method->name, make_pair(base, method));
+            interfaceTables.staticMethodsByJsName.emplace(method->jsName, make_pair(base, method));
+        }
+
+        vector<ProtocolMeta*> visitedProtocols;
+        for (ProtocolMeta* protocol : base->protocols) {
+            addProtocolMethods(protocol, interfaceTables, visitedProtocols);
+        }
+
+        const Tables& baseTables = tablesFor(base);
+        interfaceTables.staticMethodsByName.insert(baseTables.staticMethodsByName.begin(), baseTables.staticMethodsByName.end());
+        interfaceTables.staticMethodsByJsName.insert(baseTables.staticMethodsByJsName.begin(), baseTables.staticMethodsByJsName.end());
+    }
+
+    return tables.emplace(interface, std::move(interfaceTables)).first->second;
+}
+
+void InheritanceCache::addProtocolMethods(ProtocolMeta* protocol, Tables& interfaceTables, vector<ProtocolMeta*>& visitedProtocols)
+{
+    // A protocol reached again through another path has nothing left to add
+    if (find(visitedProtocols.begin(), visitedProtocols.end(), protocol) != visitedProtocols.end()) {
+        return;
+    }
+    visitedProtocols.push_back(protocol);
+
+    for (MethodMeta* method : protocol->staticMethods) {
+        interfaceTables.staticMethodsByName.emplace(method->name, make_pair(protocol, method));
+        interfaceTables.staticMethodsByJsName.emplace(method->name, make_pair(protocol, method));
+    }
+
+    for (ProtocolMeta* inheritedProtocol : protocol->protocols) {
+        addProtocolMethods(inheritedProtocol, interfaceTables, visitedProtocols);
+    }
+}
+}
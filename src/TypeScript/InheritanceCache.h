@@ -0,0 +1,52 @@
+#pragma once
+
+#include "MemberTable.h"
+#include "Meta/MetaEntities.h"
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TypeScript {
+/*
+ * \class InheritanceCache
+ * \brief Flattens the static methods an interface inherits from its superclasses and their protocols.
+ *
+ * The table of an interface is built once from the table of its superclass, so the ancestry of e.g. NSView
+ * isn't walked again for each of its subclasses and by each writer. The tables are immutable once built
+ * and are shared by reference between writers running in parallel, which read them without locking.
+ */
+class InheritanceCache {
+public:
+    typedef MemberTable<Meta::BaseClassMeta, Meta::MethodMeta> MethodTable;
+
+    enum class Key {
+        // Methods are keyed by their selector
+        Name,
+        // Methods of superclasses are keyed by their JavaScript name, methods of their protocols by selector
+        JsName
+    };
+
+    /*
+     * \brief Builds the tables of all interfaces. Called once after filtering, before the writers start.
+     */
+    static void build(const std::vector<std::pair<clang::Module*, std::vector<Meta::Meta*> > >& metasByModules);
+
+    /*
+     * \brief The static methods inherited by an interface, where the closest declaration of a key wins.
+     * The interface must have been built by build().
+     */
+    static const MethodTable& inheritedStaticMethods(Meta::InterfaceMeta* interface, Key key);
+
+private:
+    struct Tables {
+        MethodTable staticMethodsByName;
+        MethodTable staticMethodsByJsName;
+    };
+
+    static const Tables& tablesFor(Meta::InterfaceMeta* interface);
+    static void addProtocolMethods(Meta::ProtocolMeta* protocol, Tables& interfaceTables, std::vector<Meta::ProtocolMeta*>& visitedProtocols);
+
+    static std::unordered_map<Meta::InterfaceMeta*, Tables> tables;
+};
+}
@@ -0,0 +1,37 @@
+#include "MemberLowering.h"
+#include <clang/AST/DeclObjC.h>
+
+namespace TypeScript {
+using namespace Meta;
+using namespace std;
+
+ShardedMemo<MemberLowering::Key, LoweredMember, MemberLowering::KeyHash> MemberLowering::members;
+ShardedMemo<MemberLowering::Key, LoweredSignature, MemberLowering::KeyHash> MemberLowering::signatures;
+
+const LoweredMember& MemberLowering::lower(Meta::Meta* member, BaseClassMeta* owner)
+{
+    return members.get(Key(member, owner), [member, owner]() {
+        LoweredMember lowered;
+        lowered.unavailableInSwift = member->getUnavailableInSwift(owner);
+        return lowered;
+    });
+}
+
+const LoweredSignature& MemberLowering::lowerSignature(MethodMeta* method, BaseClassMeta* owner)
+{
+    return signatures.get(Key(method, owner), [method, owner]() {
+        LoweredSignature lowered;
+
+        const clang::ObjCMethodDecl& methodDecl = *clang::dyn_cast<clang::ObjCMethodDecl>(method->declaration);
+        lowered.returnType = Type::formatType(*method->signature[0], methodDecl.getReturnType());
+        if (method->name == "URLFromPasteboard:" || method->name == "URLWithDataRepresentation:relativeToURL:") {
+            lowered.returnType = "NSURL";
+        }
+        lowered.returnNullability = method->getTypeNullability(owner);
+
+        lowered.definitionParams = method->getParamsAsString(owner, ParamCallType::Definition);
+        lowered.implementationParams = method->getParamsAsString(owner, ParamCallType::Implementation);
+        return lowered;
+    });
+}
+}
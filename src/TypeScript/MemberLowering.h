@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Meta/MetaEntities.h"
+#include "Utils/ShardedMemo.h"
+#include <llvm/ADT/Hashing.h>
+#include <string>
+#include <utility>
+
+namespace TypeScript {
+/*
+ * \struct LoweredMember
+ * \brief What the writers need to know about a method or property as a member of a class.
+ */
+struct LoweredMember {
+    bool unavailableInSwift = false;
+};
+
+/*
+ * \struct LoweredSignature
+ * \brief The Swift spelling of a method's signature as a member of a class.
+ */
+struct LoweredSignature {
+    // The formatted return type, with the NSURL fixups of the JSExport writer applied
+    std::string returnType;
+    // MethodMeta::getTypeNullability() of the return type
+    std::string returnNullability;
+    // MethodMeta::getParamsAsString() for the declarations. The call arguments are only built once, by the
+    // writer of the forwarding body, and for JSValue parameters they need type arguments other methods don't have
+    std::string definitionParams;
+    std::string implementationParams;
+};
+
+/*
+ * \class MemberLowering
+ * \brief Computes the facts the TypeScript and JSExport writers derive from a member once for all of them.
+ *
+ * Members are lowered on first use and keyed by the member and the class they're written into, since the
+ * parameter names and availability depend on the owner. The lowered records are immutable and are shared by
+ * reference between writers running in parallel. The signature is lowered separately because it formats every
+ * parameter type and only the JSExport writer needs it.
+ */
+class MemberLowering {
+public:
+    static const LoweredMember& lower(Meta::Meta* member, Meta::BaseClassMeta* owner);
+
+    static const LoweredSignature& lowerSignature(Meta::MethodMeta* method, Meta::BaseClassMeta* owner);
+
+private:
+    typedef std::pair<Meta::Meta*, Meta::BaseClassMeta*> Key;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const
+        {
+            return llvm::hash_combine(key.first, key.second);
+        }
+    };
+
+    static ShardedMemo<Key, LoweredMember, KeyHash> members;
+    static ShardedMemo<Key, LoweredSignature, KeyHash> signatures;
+};
+}
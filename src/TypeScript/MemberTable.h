@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <llvm/ADT/StringRef.h>
+#include <utility>
+#include <vector>
+
+namespace TypeScript {
+/*
+ * \class MemberTable
+ * \brief The members of a class by name, in a vector sorted by name.
+ *
+ * Used by the writers in place of a std::map<std::string, ...>, it iterates in the same order. The keys aren't copied,
+ * they refer to the name or jsName of the member's meta, which outlives the table.
+ */
+template <class Owner, class Member>
+class MemberTable {
+public:
+    typedef std::pair<Owner*, Member*> mapped_type;
+    typedef std::pair<llvm::StringRef, mapped_type> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    iterator begin() { return _entries.begin(); }
+    iterator end() { return _entries.end(); }
+    const_iterator begin() const { return _entries.begin(); }
+    const_iterator end() const { return _entries.end(); }
+
+    bool empty() const { return _entries.empty(); }
+    size_t size() const { return _entries.size(); }
+
+    iterator find(llvm::StringRef key)
+    {
+        iterator it = lowerBound(key);
+        return it != _entries.end() && it->first == key ? it : _entries.end();
+    }
+
+    const_iterator find(llvm::StringRef key) const
+    {
+        return const_cast<MemberTable*>(this)->find(key);
+    }
+
+    /*
+     * \brief Adds a member unless one with the same key is already in the table, like std::map::emplace.
+     */
+    std::pair<iterator, bool> emplace(llvm::StringRef key, const mapped_type& value)
+    {
+        iterator it = lowerBound(key);
+        if (it != _entries.end() && it->first == key) {
+            return std::make_pair(it, false);
+        }
+        return std::make_pair(_entries.emplace(it, key, value), true);
+    }
+
+    std::pair<iterator, bool> emplace(const value_type& entry)
+    {
+        return emplace(entry.first, entry.second);
+    }
+
+    /*
+     * \brief Adds the members of a sorted range whose keys aren't in the table yet, in a single merge pass.
+     */
+    void insert(const_iterator first, const_iterator last)
+    {
+        std::vector<value_type> merged;
+        merged.reserve(_entries.size() + (last - first));
+        iterator own = _entries.begin();
+        while (own != _entries.end() || first != last) {
+            if (first == last || (own != _entries.end() && own->first <= first->first)) {
+                if (first != last && own->first == first->first) {
+                    ++first;
+                }
+                merged.push_back(*own++);
+            } else {
+                merged.push_back(*first++);
+            }
+        }
+        _entries.swap(merged);
+    }
+
+private:
+    iterator lowerBound(llvm::StringRef key)
+    {
+        return std::lower_bound(_entries.begin(), _entries.end(), key, [](const value_type& entry, llvm::StringRef key) {
+            return entry.first < key;
+        });
+    }
+
+    std::vector<value_type> _entries;
+};
+}
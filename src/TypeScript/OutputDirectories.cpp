@@ -0,0 +1,23 @@
+#include "OutputDirectories.h"
+#include <llvm/Support/FileSystem.h>
+
+namespace TypeScript {
+using namespace std;
+
+mutex OutputDirectories::mutex;
+unordered_set<string> OutputDirectories::created;
+
+error_code OutputDirectories::create(const string& path)
+{
+    lock_guard<std::mutex> lock(OutputDirectories::mutex);
+    if (created.find(path) != created.end()) {
+        return error_code();
+    }
+
+    error_code error = llvm::sys::fs::create_directories(path);
+    if (!error) {
+        created.insert(path);
+    }
+    return error;
+}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+
+namespace TypeScript {
+/*
+ * \class OutputDirectories
+ * \brief Creates the directories of the generated files. Every directory is created only once per run,
+ * the writers check a set of already created paths instead of touching the file system for each file.
+ */
+class OutputDirectories {
+public:
+    /*
+     * \brief Creates a directory and all of its missing parents, unless it was already created. Safe to call from writers running in parallel.
+     * \return The error of the failed creation, an empty error code on success.
+     */
+    static std::error_code create(const std::string& path);
+
+private:
+    static std::mutex mutex;
+    static std::unordered_set<std::string> created;
+};
+}
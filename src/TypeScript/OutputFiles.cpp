@@ -0,0 +1,200 @@
+#include "OutputFiles.h"
+#include <fstream>
+#include <iostream>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <sstream>
+
+namespace TypeScript {
+using namespace std;
+
+bool OutputFiles::writeIfChanged = false;
+string OutputFiles::manifestPath;
+mutex OutputFiles::mutex;
+map<string, string> OutputFiles::previousHashes;
+map<string, OutputFiles::Entry> OutputFiles::entries;
+
+void OutputFiles::enableWriteIfChanged(const string& manifestPath)
+{
+    OutputFiles::writeIfChanged = true;
+    OutputFiles::manifestPath = manifestPath;
+
+    if (manifestPath.empty()) {
+        return;
+    }
+
+    ifstream manifest(manifestPath);
+    string line;
+    while (getline(manifest, line)) {
+        istringstream fields(line);
+        string status, hash, path;
+        if (!getline(fields, status, '\t') || !getline(fields, hash, '\t') || !getline(fields, path)) {
+            continue;
+        }
+        if (status != "removed") {
+            previousHashes[path] = hash;
+        }
+    }
+}
+
+error_code OutputFiles::write(const string& path, llvm::StringRef content)
+{
+    string hash;
+    if (writeIfChanged) {
+        hash = hashOf(content);
+        if (isUnchanged(path, hash)) {
+            record(path, Status::Unchanged, hash);
+            return error_code();
+        }
+    }
+
+    error_code error;
+    llvm::raw_fd_ostream file(path, error, llvm::sys::fs::F_Text);
+    if (error) {
+        return error;
+    }
+    file << content;
+    file.close();
+
+    if (writeIfChanged) {
+        record(path, Status::Changed, hash);
+    }
+    return error_code();
+}
+
+void OutputFiles::writeManifest()
+{
+    if (!writeIfChanged || manifestPath.empty()) {
+        return;
+    }
+
+    size_t changedCount = 0, unchangedCount = 0, removedCount = 0;
+    for (auto& previous : previousHashes) {
+        if (entries.find(previous.first) == entries.end()) {
+            entries[previous.first] = { Status::Removed, previous.second };
+        }
+    }
+
+    error_code error;
+    llvm::raw_fd_ostream manifest(manifestPath, error, llvm::sys::fs::F_Text);
+    if (error) {
+        cerr << "Unable to write the output manifest " << manifestPath << ": " << error.message() << endl;
+        return;
+    }
+
+    for (auto& entry : entries) {
+        const char* status = "";
+        switch (entry.second.status) {
+        case Status::Changed:
+            status = "changed";
+            changedCount++;
+            break;
+        case Status::Unchanged:
+            status = "unchanged";
+            unchangedCount++;
+            break;
+        case Status::Removed:
+            status = "removed";
+            removedCount++;
+            break;
+        }
+        manifest << status << "\t" << entry.second.hash << "\t" << entry.first << "\n";
+    }
+    manifest.close();
+
+    cout << "[Output] " << changedCount << " changed, " << unchangedCount << " unchanged, " << removedCount << " removed, manifest: " << manifestPath << endl;
+}
+
+string OutputFiles::hashOf(llvm::StringRef content)
+{
+    llvm::MD5 md5;
+    md5.update(content);
+    return hashOf(md5);
+}
+
+string OutputFiles::hashOf(llvm::MD5& md5)
+{
+    llvm::MD5::MD5Result result;
+    md5.final(result);
+    llvm::SmallString<32> hash;
+    llvm::MD5::stringifyResult(result, hash);
+    return string(hash.str());
+}
+
+bool OutputFiles::isUnchanged(const string& path, const string& hash)
+{
+    if (!llvm::sys::fs::exists(path)) {
+        return false;
+    }
+
+    // Trust the manifest of the previous run, the file is only read when it isn't listed there
+    auto previousIt = previousHashes.find(path);
+    if (previousIt != previousHashes.end()) {
+        return previousIt->second == hash;
+    }
+
+    auto existing = llvm::MemoryBuffer::getFile(path);
+    return existing && hashOf((*existing)->getBuffer()) == hash;
+}
+
+void OutputFiles::record(const string& path, Status status, const string& hash)
+{
+    lock_guard<std::mutex> lock(OutputFiles::mutex);
+    entries[path] = { status, hash };
+}
+
+OutputFile::OutputFile(const string& path)
+    : _path(path)
+    , _writtenPath(OutputFiles::writeIfChanged ? path + ".tmp" : path)
+{
+    _stream.reset(new llvm::raw_fd_ostream(_writtenPath, _error, llvm::sys::fs::F_Text));
+    if (_error) {
+        _stream.reset();
+    }
+}
+
+OutputFile& OutputFile::operator<<(llvm::StringRef chunk)
+{
+    if (_stream) {
+        *_stream << chunk;
+        if (OutputFiles::writeIfChanged) {
+            _md5.update(chunk);
+        }
+    }
+    return *this;
+}
+
+error_code OutputFile::close()
+{
+    if (!_stream) {
+        return _error;
+    }
+
+    _stream->close();
+    bool failed = _stream->has_error();
+    // The error is reported to the caller, a raw_fd_ostream destroyed with an error aborts
+    _stream->clear_error();
+    _stream.reset();
+    if (failed) {
+        return make_error_code(errc::io_error);
+    }
+
+    if (!OutputFiles::writeIfChanged) {
+        return error_code();
+    }
+
+    string hash = OutputFiles::hashOf(_md5);
+    if (OutputFiles::isUnchanged(_path, hash)) {
+        llvm::sys::fs::remove(_writtenPath);
+        OutputFiles::record(_path, OutputFiles::Status::Unchanged, hash);
+        return error_code();
+    }
+
+    if (error_code error = llvm::sys::fs::rename(_writtenPath, _path)) {
+        return error;
+    }
+    OutputFiles::record(_path, OutputFiles::Status::Changed, hash);
+    return error_code();
+}
+}
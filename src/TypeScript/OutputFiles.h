@@ -0,0 +1,102 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+
+namespace TypeScript {
+/*
+ * \class OutputFiles
+ * \brief Writes the generated files. In write-if-changed mode a file is only rewritten when its content differs,
+ * so the modification times of unchanged outputs are kept and builds depending on them aren't invalidated.
+ *
+ * The manifest lists one output per line as <status>\t<md5>\t<path>, where status is changed, unchanged or removed.
+ * It is read on the next run, so the content of unchanged files doesn't have to be read again to compare it.
+ */
+class OutputFiles {
+public:
+    /*
+     * \brief Enables write-if-changed mode. Has to be called before any file is written.
+     * \param manifestPath The manifest of the previous run is read from and the new one is written to this file. May be empty.
+     */
+    static void enableWriteIfChanged(const std::string& manifestPath);
+
+    /*
+     * \brief Writes a file, or skips it in write-if-changed mode if its content is the same. Safe to call from writers running in parallel.
+     * \return The error of the failed write, an empty error code on success.
+     */
+    static std::error_code write(const std::string& path, llvm::StringRef content);
+
+    /*
+     * \brief Writes the manifest if one was given, outputs of the previous run which weren't written again are listed as removed.
+     */
+    static void writeManifest();
+
+private:
+    friend class OutputFile;
+
+    enum class Status {
+        Changed,
+        Unchanged,
+        Removed
+    };
+
+    struct Entry {
+        Status status;
+        std::string hash;
+    };
+
+    static std::string hashOf(llvm::StringRef content);
+    static std::string hashOf(llvm::MD5& md5);
+    static bool isUnchanged(const std::string& path, const std::string& hash);
+    static void record(const std::string& path, Status status, const std::string& hash);
+
+    static bool writeIfChanged;
+    static std::string manifestPath;
+    static std::mutex mutex;
+    // The hashes of the outputs listed in the manifest of the previous run
+    static std::map<std::string, std::string> previousHashes;
+    // The outputs of this run, sorted by path so the manifest is stable
+    static std::map<std::string, Entry> entries;
+};
+
+/*
+ * \class OutputFile
+ * \brief A file which is written in chunks, for outputs too large to be built in memory first.
+ *
+ * In write-if-changed mode the chunks go to a temporary file next to the output while their hash is computed,
+ * the output is only replaced by it on close() if the hash differs.
+ */
+class OutputFile {
+public:
+    explicit OutputFile(const std::string& path);
+
+    /*
+     * \brief The error of opening the file, an empty error code if it can be written.
+     */
+    std::error_code error() const
+    {
+        return _error;
+    }
+
+    OutputFile& operator<<(llvm::StringRef chunk);
+
+    /*
+     * \brief Finishes the file.
+     * \return The error of the failed write, an empty error code on success.
+     */
+    std::error_code close();
+
+private:
+    std::string _path;
+    std::string _writtenPath;
+    std::unique_ptr<llvm::raw_fd_ostream> _stream;
+    llvm::MD5 _md5;
+    std::error_code _error;
+};
+}
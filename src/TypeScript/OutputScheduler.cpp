@@ -0,0 +1,207 @@
+#include "OutputScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace TypeScript {
+using namespace std;
+
+// The job which runs on the current thread, its output is buffered until all jobs are done
+static thread_local ostringstream* currentOut = nullptr;
+static thread_local ostringstream* currentErr = nullptr;
+
+OutputScheduler::OutputScheduler(unsigned threadsCount)
+    : _threadsCount(threadsCount ? threadsCount : max(thread::hardware_concurrency(), 1u))
+{
+}
+
+void OutputScheduler::addJob(size_t weight, Job job, const string& chain)
+{
+    _jobs.emplace_back(new ScheduledJob());
+    ScheduledJob* scheduledJob = _jobs.back().get();
+    scheduledJob->job = std::move(job);
+    scheduledJob->weight = weight;
+
+    if (chain.empty()) {
+        return;
+    }
+
+    auto tailIt = find_if(_chainTails.begin(), _chainTails.end(), [&chain](const pair<string, ScheduledJob*>& tail) {
+        return tail.first == chain;
+    });
+    if (tailIt == _chainTails.end()) {
+        _chainTails.emplace_back(chain, scheduledJob);
+    } else {
+        tailIt->second->next = scheduledJob;
+        scheduledJob->waitsForPrevious = true;
+        tailIt->second = scheduledJob;
+    }
+}
+
+void OutputScheduler::addMessage(const string& message)
+{
+    _jobs.emplace_back(new ScheduledJob());
+    _jobs.back()->weight = 0;
+    _jobs.back()->out << message;
+}
+
+ostream& OutputScheduler::out()
+{
+    return currentOut ? *currentOut : cout;
+}
+
+ostream& OutputScheduler::err()
+{
+    return currentErr ? *currentErr : cerr;
+}
+
+void OutputScheduler::run()
+{
+    auto start = chrono::steady_clock::now();
+
+    // A chain can only start with its first job, so it is prioritized by the weight of the whole chain
+    vector<pair<size_t, ScheduledJob*> > ready;
+    for (auto& job : _jobs) {
+        if (!job->job) {
+            continue;
+        }
+        _remainingJobs++;
+        if (!job->waitsForPrevious) {
+            size_t weight = 0;
+            for (ScheduledJob* chained = job.get(); chained; chained = chained->next) {
+                weight += chained->weight;
+            }
+            ready.emplace_back(weight, job.get());
+        }
+    }
+    stable_sort(ready.begin(), ready.end(), [](const pair<size_t, ScheduledJob*>& a, const pair<size_t, ScheduledJob*>& b) {
+        return a.first > b.first;
+    });
+
+    size_t threadsCount = min<size_t>(_threadsCount, max<size_t>(ready.size(), 1));
+    size_t jobsCount = _remainingJobs;
+    _queues.clear();
+    for (size_t i = 0; i < threadsCount; i++) {
+        _queues.emplace_back(new WorkerQueue());
+    }
+
+    // Deal the jobs round-robin, so every worker starts with one of the largest ones
+    for (size_t i = 0; i < ready.size(); i++) {
+        _queues[i % threadsCount]->jobs.push_back(ready[i].second);
+    }
+
+    vector<thread> workers;
+    for (size_t i = 1; i < threadsCount; i++) {
+        workers.emplace_back(&OutputScheduler::work, this, i);
+    }
+    work(0);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+    exception_ptr exception;
+    for (auto& job : _jobs) {
+        cout << job->out.str();
+        cerr << job->err.str();
+        if (job->exception && !exception) {
+            exception = job->exception;
+        }
+    }
+    _jobs.clear();
+    _chainTails.clear();
+
+    cout << "[Output] " << jobsCount << " jobs on " << threadsCount << " threads: " << elapsed.count() << " ms." << endl;
+
+    if (exception) {
+        rethrow_exception(exception);
+    }
+}
+
+void OutputScheduler::work(size_t workerIndex)
+{
+    while (true) {
+        size_t generation;
+        {
+            lock_guard<mutex> lock(_stateMutex);
+            if (_remainingJobs == 0) {
+                return;
+            }
+            generation = _queuedGeneration;
+        }
+
+        if (ScheduledJob* job = take(workerIndex)) {
+            execute(workerIndex, job);
+            continue;
+        }
+
+        // Nothing to take, but some jobs are still running and may queue the next job of their chain
+        unique_lock<mutex> lock(_stateMutex);
+        _stateChanged.wait(lock, [this, generation]() {
+            return _remainingJobs == 0 || _queuedGeneration != generation;
+        });
+    }
+}
+
+OutputScheduler::ScheduledJob* OutputScheduler::take(size_t workerIndex)
+{
+    {
+        WorkerQueue& own = *_queues[workerIndex];
+        lock_guard<mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            ScheduledJob* job = own.jobs.front();
+            own.jobs.pop_front();
+            return job;
+        }
+    }
+
+    // Steal the smallest job of another worker, its owner keeps working on the large ones
+    for (size_t i = 1; i < _queues.size(); i++) {
+        WorkerQueue& victim = *_queues[(workerIndex + i) % _queues.size()];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            ScheduledJob* job = victim.jobs.back();
+            victim.jobs.pop_back();
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void OutputScheduler::push(size_t workerIndex, ScheduledJob* job)
+{
+    {
+        WorkerQueue& own = *_queues[workerIndex];
+        lock_guard<mutex> lock(own.mutex);
+        own.jobs.push_front(job);
+    }
+    lock_guard<mutex> lock(_stateMutex);
+    _queuedGeneration++;
+    _stateChanged.notify_all();
+}
+
+void OutputScheduler::execute(size_t workerIndex, ScheduledJob* job)
+{
+    currentOut = &job->out;
+    currentErr = &job->err;
+    try {
+        job->job();
+    } catch (...) {
+        job->exception = current_exception();
+    }
+    currentOut = nullptr;
+    currentErr = nullptr;
+
+    if (job->next) {
+        push(workerIndex, job->next);
+    }
+
+    lock_guard<mutex> lock(_stateMutex);
+    if (--_remainingJobs == 0) {
+        _stateChanged.notify_all();
+    }
+}
+}
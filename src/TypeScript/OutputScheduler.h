@@ -0,0 +1,93 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TypeScript {
+/*
+ * \class OutputScheduler
+ * \brief Runs the per-module jobs of the output writers on a work-stealing thread pool.
+ *
+ * Jobs are started largest first. Everything a job logs through out() and err() is buffered
+ * and printed in the order in which the jobs were added, so the console output doesn't depend
+ * on how the jobs were scheduled.
+ */
+class OutputScheduler {
+public:
+    typedef std::function<void()> Job;
+
+    /*
+     * \param threadsCount The number of worker threads, defaults to the number of hardware threads.
+     */
+    explicit OutputScheduler(unsigned threadsCount = 0);
+
+    /*
+     * \brief Adds a job.
+     * \param weight The estimated cost of the job, e.g. the number of metas in its module.
+     * \param chain Jobs with the same non-empty chain run one after another in the order in which they
+     * were added. Used by writers whose state depends on the order of the modules.
+     */
+    void addJob(size_t weight, Job job, const std::string& chain = "");
+
+    /*
+     * \brief Adds text which is printed between the output of the jobs added before and after it.
+     */
+    void addMessage(const std::string& message);
+
+    /*
+     * \brief Runs all added jobs and prints their output. Rethrows the first exception thrown by a job.
+     */
+    void run();
+
+    /*
+     * \brief The stream for console output of the running job, or std::cout outside of a job.
+     */
+    static std::ostream& out();
+
+    /*
+     * \brief The stream for error output of the running job, or std::cerr outside of a job.
+     */
+    static std::ostream& err();
+
+private:
+    struct ScheduledJob {
+        Job job;
+        size_t weight = 0;
+        // The job of the same chain which is started after this one, if any
+        ScheduledJob* next = nullptr;
+        bool waitsForPrevious = false;
+        std::ostringstream out;
+        std::ostringstream err;
+        std::exception_ptr exception;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<ScheduledJob*> jobs;
+    };
+
+    void work(size_t workerIndex);
+    ScheduledJob* take(size_t workerIndex);
+    void push(size_t workerIndex, ScheduledJob* job);
+    void execute(size_t workerIndex, ScheduledJob* job);
+
+    unsigned _threadsCount;
+    std::vector<std::unique_ptr<ScheduledJob> > _jobs;
+    std::vector<std::pair<std::string, ScheduledJob*> > _chainTails;
+
+    std::vector<std::unique_ptr<WorkerQueue> > _queues;
+    std::mutex _stateMutex;
+    std::condition_variable _stateChanged;
+    size_t _remainingJobs = 0;
+    // Incremented whenever a job is queued so that idle workers know to look again
+    size_t _queuedGeneration = 0;
+};
+}
@@ -0,0 +1,117 @@
+//
+//  ShardedMemo.h
+//  MetadataGenerator
+//
+//  Values computed once per key by writers running in parallel. A value is
+//  computed without holding a lock; if two writers compute the same key, the
+//  value inserted first is kept and both get it. The keys are spread over
+//  shards with a lock each, so writers looking up different keys rarely wait
+//  on each other. Values aren't moved once inserted, so references to them
+//  stay valid until clear().
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+template <class Key, class Value, class Hash = std::hash<Key>, size_t ShardsCount = 16>
+class ShardedMemo {
+public:
+    template <class Compute>
+    const Value& get(const Key& key, Compute compute)
+    {
+        Shard& shard = shardFor(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto valueIt = shard.values.find(key);
+            if (valueIt != shard.values.end()) {
+                shard.hits++;
+                return valueIt->second;
+            }
+        }
+
+        Value value = compute();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto inserted = shard.values.emplace(key, std::move(value));
+        if (inserted.second) {
+            shard.computed++;
+        }
+        return inserted.first->second;
+    }
+
+    // Adds a value which wasn't computed here, e.g. one read from a cache, unless the key has one
+    void insert(const Key& key, Value value)
+    {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.values.emplace(key, std::move(value));
+    }
+
+    template <class Visit>
+    void forEach(Visit visit)
+    {
+        for (Shard& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto& valuePair : shard.values) {
+                visit(valuePair.first, valuePair.second);
+            }
+        }
+    }
+
+    size_t size()
+    {
+        return sum([](const Shard& shard) { return shard.values.size(); });
+    }
+
+    // The lookups which found a value
+    size_t hits()
+    {
+        return sum([](const Shard& shard) { return shard.hits; });
+    }
+
+    // The values get() computed and kept
+    size_t computed()
+    {
+        return sum([](const Shard& shard) { return shard.computed; });
+    }
+
+    void clear()
+    {
+        for (Shard& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.values.clear();
+            shard.hits = 0;
+            shard.computed = 0;
+        }
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<Key, Value, Hash> values;
+        size_t hits = 0;
+        size_t computed = 0;
+    };
+
+    Shard& shardFor(const Key& key)
+    {
+        return _shards[Hash()(key) % ShardsCount];
+    }
+
+    template <class Count>
+    size_t sum(Count count)
+    {
+        size_t total = 0;
+        for (Shard& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += count(shard);
+        }
+        return total;
+    }
+
+    Shard _shards[ShardsCount];
+};
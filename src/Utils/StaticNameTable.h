@@ -0,0 +1,143 @@
+//
+//  StaticNameTable.h
+//  MetadataGenerator
+//
+//  Fixed sets and maps of names, hashed while compiling. A table is a constant
+//  built by a constexpr function, so nothing is constructed at startup, and
+//  looking a name up hashes and compares it in place without allocating or
+//  changing the table.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <llvm/ADT/StringRef.h>
+
+namespace StaticNameTable {
+// FNV-1a, for the names of a table while compiling and for the names looked up at runtime
+constexpr uint32_t hashOf(const char* name, size_t length)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= static_cast<unsigned char>(name[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+constexpr size_t lengthOf(const char* name)
+{
+  size_t length = 0;
+  while (name[length]) {
+    length++;
+  }
+  return length;
+}
+
+// A power of two with at least twice as many slots as names, so a lookup probes a slot or two
+constexpr size_t capacityFor(size_t count)
+{
+  size_t capacity = 1;
+  while (capacity < 2 * count) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+struct Pair {
+  const char* name;
+  const char* value;
+};
+
+template <size_t Capacity>
+class Table {
+public:
+  constexpr Table()
+    : _slots{}
+  {
+  }
+
+  bool contains(llvm::StringRef name) const
+  {
+    return find(name) != nullptr;
+  }
+
+  // The value of name, empty if the table doesn't have it
+  llvm::StringRef lookup(llvm::StringRef name) const
+  {
+    const Slot* slot = find(name);
+    return slot ? llvm::StringRef(slot->value, slot->valueLength) : llvm::StringRef();
+  }
+
+  // Like the initializer lists of std::map and std::unordered_set, the first of the same names is kept
+  constexpr void insert(const char* name, const char* value)
+  {
+    size_t length = lengthOf(name);
+    size_t index = hashOf(name, length) & (Capacity - 1);
+    while (_slots[index].name) {
+      if (equal(_slots[index], name, length)) {
+        return;
+      }
+      index = (index + 1) & (Capacity - 1);
+    }
+    _slots[index] = { name, length, value, value ? lengthOf(value) : 0 };
+  }
+
+private:
+  struct Slot {
+    // nullptr for an empty slot
+    const char* name;
+    size_t length;
+    const char* value;
+    size_t valueLength;
+  };
+
+  static constexpr bool equal(const Slot& slot, const char* name, size_t length)
+  {
+    if (slot.length != length) {
+      return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+      if (slot.name[i] != name[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const Slot* find(llvm::StringRef name) const
+  {
+    size_t index = hashOf(name.data(), name.size()) & (Capacity - 1);
+    while (_slots[index].name) {
+      if (name == llvm::StringRef(_slots[index].name, _slots[index].length)) {
+        return &_slots[index];
+      }
+      index = (index + 1) & (Capacity - 1);
+    }
+    return nullptr;
+  }
+
+  Slot _slots[Capacity];
+};
+
+template <size_t Count>
+constexpr Table<capacityFor(Count)> makeSet(const char* const (&names)[Count])
+{
+  Table<capacityFor(Count)> table;
+  for (size_t i = 0; i < Count; i++) {
+    table.insert(names[i], nullptr);
+  }
+  return table;
+}
+
+template <size_t Count>
+constexpr Table<capacityFor(Count)> makeMap(const Pair (&pairs)[Count])
+{
+  Table<capacityFor(Count)> table;
+  for (size_t i = 0; i < Count; i++) {
+    table.insert(pairs[i].name, pairs[i].value);
+  }
+  return table;
+}
+}
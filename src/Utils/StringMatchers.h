@@ -0,0 +1,140 @@
+//
+//  StringMatchers.h
+//  MetadataGenerator
+//
+//  Hand-written replacements for the std::regex patterns the writers and the type
+//  formatting used to build and run for every type and member. Each matcher names
+//  the pattern it replaces and gives the same result for any input.
+//
+
+#pragma once
+
+#include <string>
+
+namespace StringMatchers {
+// `\w`
+static inline bool isWordChar(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// `^\w+$` for the characters in [begin, end)
+static inline bool isWord(const std::string& s, size_t begin, size_t end)
+{
+  if (begin >= end) {
+    return false;
+  }
+  for (size_t i = begin; i < end; i++) {
+    if (!isWordChar(s[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// `.` doesn't match line terminators, so patterns like `.*JSValue.*` never match multi-line strings
+static inline bool isSingleLine(const std::string& s)
+{
+  return s.find_first_of("\n\r") == std::string::npos;
+}
+
+// regex_match(s, regex(".*" + needle + ".*"))
+static inline bool lineContains(const std::string& s, const std::string& needle)
+{
+  return isSingleLine(s) && s.find(needle) != std::string::npos;
+}
+
+// regex_match(s, regex(".*" + suffix + "$"))
+static inline bool lineEndsWith(const std::string& s, const std::string& suffix)
+{
+  return isSingleLine(s) && s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// regex_replace(s, regex("^" + prefix), replacement)
+static inline std::string replacePrefix(const std::string& s, const std::string& prefix, const std::string& replacement)
+{
+  if (s.compare(0, prefix.size(), prefix) != 0) {
+    return s;
+  }
+  return replacement + s.substr(prefix.size());
+}
+
+// regex_replace(s, regex(suffix + "$"), replacement)
+static inline std::string replaceSuffix(const std::string& s, const std::string& suffix, const std::string& replacement)
+{
+  if (s.size() < suffix.size() || s.compare(s.size() - suffix.size(), suffix.size(), suffix) != 0) {
+    return s;
+  }
+  return s.substr(0, s.size() - suffix.size()) + replacement;
+}
+
+// regex_replace(s, regex("(\\w+)" + suffix + "$"), "$1" + replacement)
+static inline std::string replaceWordSuffix(const std::string& s, const std::string& suffix, const std::string& replacement)
+{
+  if (s.size() <= suffix.size() || !isWordChar(s[s.size() - suffix.size() - 1])) {
+    return s;
+  }
+  return replaceSuffix(s, suffix, replacement);
+}
+
+// regex_replace(s, regex("^(NS|AV|IK)"), "")
+static inline std::string removeFrameworkPrefix(const std::string& s)
+{
+  if (s.size() >= 2 && ((s[0] == 'N' && s[1] == 'S') || (s[0] == 'A' && s[1] == 'V') || (s[0] == 'I' && s[1] == 'K'))) {
+    return s.substr(2);
+  }
+  return s;
+}
+
+// The argument of `^\w+<(\w+)>$`, or of `^<outer><(\w+)>$` if outer isn't empty. Empty if the string doesn't match.
+static inline std::string genericArgument(const std::string& s, const std::string& outer = "")
+{
+  size_t open = s.find('<');
+  if (open == std::string::npos || s.back() != '>') {
+    return "";
+  }
+  if (outer.empty() ? !isWord(s, 0, open) : s.compare(0, open, outer) != 0) {
+    return "";
+  }
+  if (!isWord(s, open + 1, s.size() - 1)) {
+    return "";
+  }
+  return s.substr(open + 1, s.size() - open - 2);
+}
+
+// regex_match(s, regex("^\\w+<\\w+,id>$"))
+static inline bool isGenericWithIdValue(const std::string& s)
+{
+  static const std::string idValue = ",id>";
+  size_t open = s.find('<');
+  if (open == std::string::npos || s.size() < open + 1 + idValue.size()) {
+    return false;
+  }
+  size_t comma = s.size() - idValue.size();
+  return s.compare(comma, idValue.size(), idValue) == 0 && isWord(s, 0, open) && isWord(s, open + 1, comma);
+}
+
+// regex_replace(s, regex(outer + "<\\w+>"), replacement)
+static inline std::string replaceGenerics(const std::string& s, const std::string& outer, const std::string& replacement)
+{
+  std::string result;
+  size_t copied = 0;
+  size_t pos = 0;
+  while ((pos = s.find(outer + "<", pos)) != std::string::npos) {
+    size_t argument = pos + outer.size() + 1;
+    size_t close = argument;
+    while (close < s.size() && isWordChar(s[close])) {
+      close++;
+    }
+    if (close == argument || close == s.size() || s[close] != '>') {
+      pos++;
+      continue;
+    }
+    result.append(s, copied, pos - copied);
+    result += replacement;
+    copied = pos = close + 1;
+  }
+  result.append(s, copied, std::string::npos);
+  return result;
+}
+}
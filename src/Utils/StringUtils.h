@@ -5,6 +5,7 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <string>
 
@@ -43,19 +44,22 @@ static inline bool ends_with(const std::string value, const std::string suffix)
   return std::equal(suffix.rbegin(), suffix.rend(), value.rbegin());
 }
 
+// The non-empty parts of input between the delimiters
 template <class OutputIterator, typename CharT>
 size_t split(const std::basic_string<CharT>& input, CharT delim, OutputIterator output)
 {
   size_t count = 0;
-  std::basic_stringstream<CharT> ss(input);
-  std::basic_string<CharT> item;
-  while (std::getline(ss, item, delim)) {
-    if (item.size() == 0) {
-      continue;
+  size_t begin = 0;
+  while (begin <= input.size()) {
+    size_t end = input.find(delim, begin);
+    if (end == std::basic_string<CharT>::npos) {
+      end = input.size();
     }
-    
-    *(output++) = item;
-    count++;
+    if (end > begin) {
+      *(output++) = input.substr(begin, end - begin);
+      count++;
+    }
+    begin = end + 1;
   }
   
   return count;
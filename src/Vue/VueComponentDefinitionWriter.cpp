@@ -4,13 +4,17 @@
 #include "Meta/MetaFactory.h"
 #include "Meta/Utils.h"
 #include "Meta/NameRetrieverVisitor.h"
+#include "TypeScript/OutputDirectories.h"
+#include "TypeScript/OutputFiles.h"
+#include "TypeScript/OutputScheduler.h"
+#include "Utils/StringMatchers.h"
+#include "Utils/StaticNameTable.h"
 #include "Utils/StringUtils.h"
 #include <algorithm>
 #include <iostream>
 #include <cctype>
 #include <clang/AST/DeclObjC.h>
 #include <iterator>
-#include <regex>
 #include "yaml-cpp/yaml.h"
 #include <cstdlib>
 
@@ -20,7 +24,7 @@ using namespace std;
 
 string VueComponentDefinitionWriter::outputVueFolder = "";
 
-static unordered_set<string> hiddenMethods = {
+static constexpr auto hiddenMethods = StaticNameTable::makeSet({
   "alloc",
   "allocWith",
   "allocWithZone"
@@ -32,8 +36,10 @@ static unordered_set<string> hiddenMethods = {
   "zone",
   "class",
   "subscript"
-};
+});
 
+// Shared by the components of all modules, so which props get written depends on the
+// order of the modules. That's why the Vue jobs of the output scheduler are chained.
 static unordered_set<string> writtenProps = {};
 
 string kebabCase(string camelCase) {
@@ -58,9 +64,9 @@ inline bool endsWith(string const & value, string const & ending)
 }
 
 string getPropsEntry(string returnType, PropertyMeta* meta = NULL) {
-  ostringstream output;
+  EmissionBuffer output;
   
-  if (VueComponentFormatter::nativeTypes[returnType]) {
+  if (VueComponentFormatter::isNativeType(returnType)) {
     returnType[0] = toupper(returnType[0]);
     output << "type: " << returnType;
   }
@@ -267,7 +273,7 @@ string VueComponentDefinitionWriter::writeMethod(CompoundMemberMap<MethodMeta>::
   BaseClassMeta* memberOwner = methodPair.second.first;
   MethodMeta* method = methodPair.second.second;
   
-  if (hiddenMethods.find(method->jsName) != hiddenMethods.end()) {
+  if (hiddenMethods.contains(method->jsName)) {
     return string();
   }
   
@@ -284,14 +290,14 @@ string VueComponentDefinitionWriter::writeMethod(CompoundMemberMap<MethodMeta>::
 
 string VueComponentDefinitionWriter::writeMethod(MethodMeta* method, BaseClassMeta* owner, string keyword)
 {
-  ostringstream output;
+  EmissionBuffer output;
   
   const clang::ObjCMethodDecl& methodDecl = *clang::dyn_cast<clang::ObjCMethodDecl>(method->declaration);
   
   string name = method->jsName;
   
   if (!keyword.empty()) {
-    cerr << "Skipping prop " + name + " because it has a keyword " + keyword << endl;
+    OutputScheduler::err() << "Skipping prop " + name + " because it has a keyword " + keyword << endl;
     return output.str();
   }
   
@@ -327,7 +333,7 @@ string VueComponentDefinitionWriter::writeMethod(MethodMeta* method, BaseClassMe
 
 string VueComponentDefinitionWriter::writeMethodComputed(MethodMeta* method, BaseClassMeta* owner)
 {
-  ostringstream output;
+  EmissionBuffer output;
   const clang::ObjCMethodDecl& methodDecl = *clang::dyn_cast<clang::ObjCMethodDecl>(method->declaration);
   string name = method->jsName;
   
@@ -345,7 +351,7 @@ string VueComponentDefinitionWriter::writeMethodComputed(MethodMeta* method, Bas
   setterType = VueComponentFormatter::current.vuePropifyTypeName(setterType);
   
   // Native types like String and Number don't get any special treatment
-  if (VueComponentFormatter::nativeTypes[setterType]) {
+  if (VueComponentFormatter::isNativeType(setterType)) {
     return output.str();
   }
   
@@ -356,9 +362,9 @@ string VueComponentDefinitionWriter::writeMethodComputed(MethodMeta* method, Bas
   return output.str();
 }
 
-void VueComponentDefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta* owner, InterfaceMeta* target, CompoundMemberMap<PropertyMeta> baseClassProperties)
+void VueComponentDefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta* owner, InterfaceMeta* target, const CompoundMemberMap<PropertyMeta>& baseClassProperties)
 {
-  if (hiddenMethods.find(propertyMeta->jsName) != hiddenMethods.end()) {
+  if (hiddenMethods.contains(propertyMeta->jsName)) {
     return;
   }
   
@@ -380,7 +386,7 @@ void VueComponentDefinitionWriter::writeProperty(PropertyMeta* propertyMeta, Bas
 
 string VueComponentDefinitionWriter::writeProperty(PropertyMeta* meta, BaseClassMeta* owner, bool optOutTypeChecking)
 {
-  ostringstream output;
+  EmissionBuffer output;
   
   if (!meta->setter) {
     return output.str();
@@ -432,7 +438,7 @@ string VueComponentDefinitionWriter::writeProperty(PropertyMeta* meta, BaseClass
 
 string VueComponentDefinitionWriter::writePropertyComputed(PropertyMeta* meta, BaseClassMeta* owner)
 {
-  ostringstream output;
+  EmissionBuffer output;
   
   // Can't set a value on read-only properties
   if (!meta->setter) {
@@ -458,16 +464,14 @@ string VueComponentDefinitionWriter::writePropertyComputed(PropertyMeta* meta, B
     propertyType = retType2;
   }
   
-  regex genericRe("NSArray<id>");
-  propertyType = regex_replace(propertyType, genericRe, "[Object]");
-  regex genericRe2("Set<\\w+>");
-  propertyType = regex_replace(propertyType, genericRe2, "Set");
+  propertyType = StringUtils::replaceString(propertyType, "NSArray<id>", "[Object]");
+  propertyType = StringMatchers::replaceGenerics(propertyType, "Set", "Set");
 
   string name = meta->jsName;
   string kebabName = kebabCase(meta->jsName);
   
   // Native types like String and Number don't get any special treatment
-  if (propertyType != "object" && VueComponentFormatter::nativeTypes[propertyType]) {
+  if (propertyType != "object" && VueComponentFormatter::isNativeType(propertyType)) {
     return output.str();
   }
   
@@ -506,7 +510,6 @@ string VueComponentDefinitionWriter::write()
       }
     }
     
-    _buffer.str("");
     _buffer.clear();
   }
   
@@ -515,19 +518,17 @@ string VueComponentDefinitionWriter::write()
 
 void VueComponentDefinitionWriter::writeVueComponent(::Meta::Meta* meta, string frameworkName)
 {
-  auto buffer = _buffer.str();
+  llvm::StringRef buffer = _buffer.ref();
   if (buffer.empty() || buffer == "\n" || meta->jsName[0] == '_') { return; }
   
   string jsPath = outputVueFolder + "/" + frameworkName + "/";
-  string mkdirCmd = "mkdir -p '" + jsPath + "'";
-  const size_t mkdirReturn = system(mkdirCmd.c_str());
+  error_code mkdirError = OutputDirectories::create(jsPath);
   
-  if (mkdirReturn < 0)  {
-    cout << "Error creating directory using command: " << mkdirCmd << endl;
+  if (mkdirError) {
+    OutputScheduler::out() << "Error creating directory " << jsPath << ": " << mkdirError.message() << endl;
     return;
   }
   
-  error_code writeError;
   auto interface = static_cast<InterfaceMeta*>(meta);
   string moduleName = interface->module->getTopLevelModule()->Name;
   string baseModuleName = "";
@@ -536,16 +537,10 @@ void VueComponentDefinitionWriter::writeVueComponent(::Meta::Meta* meta, string
     baseModuleName = interface->base->module->getTopLevelModule()->Name;
   }
   
-  regex frameworkPrefixes("^NS");
-  regex viewSuffix("View$");
   string shortName = interface->jsName;
   
-  llvm::raw_fd_ostream jsFile(jsPath + shortName + ".vue", writeError, llvm::sys::fs::F_Text);
-  
-  if (writeError) {
-    cout << writeError.message();
-    return;
-  }
+  string content;
+  llvm::raw_string_ostream jsFile(content);
   
   jsFile << "<script lang='ts'>\n";
   jsFile << "import { PropType, h, defineComponent } from '@vue/runtime-core';\n";
@@ -608,9 +603,14 @@ void VueComponentDefinitionWriter::writeVueComponent(::Meta::Meta* meta, string
   jsFile << "});\n";
   jsFile << "</script>\n";
   
-  jsFile.close();
+  error_code writeError = OutputFiles::write(jsPath + shortName + ".vue", jsFile.str());
+  
+  if (writeError) {
+    OutputScheduler::out() << writeError.message();
+    return;
+  }
   
-  cout << "Wrote " << frameworkName + "/" + shortName + ".vue" << endl;
+  OutputScheduler::out() << "Wrote " << frameworkName + "/" + shortName + ".vue" << endl;
 }
 }
 
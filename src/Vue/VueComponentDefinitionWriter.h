@@ -1,9 +1,10 @@
 #pragma once
 
 #include "TypeScript/DocSetManager.h"
+#include "TypeScript/EmissionBuffer.h"
+#include "TypeScript/MemberTable.h"
 #include "Meta/MetaEntities.h"
 #include <Meta/TypeFactory.h>
-#include <sstream>
 #include <string>
 #include <unordered_set>
 
@@ -51,16 +52,10 @@ public:
 
 private:
   template <class Member>
-  using CompoundMemberMap = std::map<std::string, std::pair<Meta::BaseClassMeta*, Member*> >;
+  using CompoundMemberMap = MemberTable<Meta::BaseClassMeta, Member>;
   
   void writeMembers(const std::vector<Meta::RecordField>& fields, std::vector<TSComment> fieldsComments);
-  void writeProperty(Meta::PropertyMeta* meta, Meta::BaseClassMeta* owner, Meta::InterfaceMeta* target, CompoundMemberMap<Meta::PropertyMeta> compoundProperties);
-  
-  static void getInheritedMembersRecursive(Meta::InterfaceMeta* interface,
-                                           CompoundMemberMap<Meta::MethodMeta>* staticMethods,
-                                           CompoundMemberMap<Meta::MethodMeta>* instanceMethods,
-                                           CompoundMemberMap<Meta::PropertyMeta>* staticProperties,
-                                           CompoundMemberMap<Meta::PropertyMeta>* instanceProperties);
+  void writeProperty(Meta::PropertyMeta* meta, Meta::BaseClassMeta* owner, Meta::InterfaceMeta* target, const CompoundMemberMap<Meta::PropertyMeta>& compoundProperties);
   
   static void getProtocolMembersRecursive(Meta::ProtocolMeta* protocol,
                                           CompoundMemberMap<Meta::MethodMeta>* staticMethods,
@@ -80,6 +75,6 @@ private:
   static std::unordered_set<std::string> classesToWrite;
 
   std::unordered_set<std::string> _importedModules;
-  std::ostringstream _buffer;
+  EmissionBuffer _buffer;
 };
 }
@@ -1,7 +1,10 @@
 #include "TypeScript/DefinitionWriter.h"
 #include "VueComponentDefinitionWriter.h"
+#include "Meta/TypeFormatCache.h"
 #include "Meta/Utils.h"
 #include "Meta/NameRetrieverVisitor.h"
+#include "TypeScript/OutputScheduler.h"
+#include "Utils/StaticNameTable.h"
 #include "Utils/StringUtils.h"
 #include <algorithm>
 #include <clang/AST/DeclObjC.h>
@@ -14,9 +17,9 @@ namespace TypeScript {
 using namespace Meta;
 using namespace std;
 
-VueComponentFormatter VueComponentFormatter::current = VueComponentFormatter();
+const VueComponentFormatter VueComponentFormatter::current = VueComponentFormatter();
 
-map<string, bool> VueComponentFormatter::nativeTypes = {
+const map<string, bool> VueComponentFormatter::nativeTypes = {
   { "object", true },
   { "array", true },
   { "number", true },
@@ -27,9 +30,9 @@ map<string, bool> VueComponentFormatter::nativeTypes = {
   { "Boolean", true }
 };
 
-string VueComponentFormatter::vuePropifyTypeName(const string& jsName)
+string VueComponentFormatter::vuePropifyTypeName(const string& jsName) const
 {
-  static map<string, string> jsNames = {
+  static constexpr auto jsNames = StaticNameTable::makeMap({
     { "CGDict", "Object" },
     { "NSDictionary", "Object" },
     { "NSArray", "Array" },
@@ -52,16 +55,23 @@ string VueComponentFormatter::vuePropifyTypeName(const string& jsName)
     { "AnyClass", "Object" },
     { "AnyObject", "Object" },
     { "Bool", "Boolean" }
-  };
+  });
   
-  if (!jsNames[jsName].empty()) {
-    return jsNames[jsName];
+  llvm::StringRef propType = jsNames.lookup(jsName);
+  if (!propType.empty()) {
+    return propType.str();
   }
   
   return jsName;
 }
 
-vector<string> VueComponentFormatter::split2(string const &input) {
+bool VueComponentFormatter::isNativeType(const string& typeName)
+{
+  auto nativeTypeIt = nativeTypes.find(typeName);
+  return nativeTypeIt != nativeTypes.end() && nativeTypeIt->second;
+}
+
+vector<string> VueComponentFormatter::split2(string const &input) const {
   istringstream buffer(input);
   
   vector<string> ret{
@@ -72,7 +82,7 @@ vector<string> VueComponentFormatter::split2(string const &input) {
   return ret;
 }
 
-string VueComponentFormatter::formatTypeId(const IdType& idType, const clang::QualType pointerType, const bool ignorePointerType) {
+string VueComponentFormatter::formatTypeId(const IdType& idType, const clang::QualType pointerType, const bool ignorePointerType) const {
   string out = "";
   
   const clang::Type* typePtr = pointerType.getTypePtr();
@@ -103,11 +113,18 @@ string VueComponentFormatter::formatTypeId(const IdType& idType, const clang::Qu
   }
 }
 
-string VueComponentFormatter::formatTypePointer(const PointerType& pointerType, const clang::QualType pointerQualType, const bool ignorePointerType) {
+string VueComponentFormatter::formatTypePointer(const PointerType& pointerType, const clang::QualType pointerQualType, const bool ignorePointerType) const {
   return Type::lookupApiNotes(formatType(*pointerType.innerType, pointerQualType, true));
 }
 
-string VueComponentFormatter::formatType(const Type& type, const clang::QualType pointerType, const bool ignorePointerType)
+string VueComponentFormatter::formatType(const Type& type, const clang::QualType pointerType, const bool ignorePointerType) const
+{
+  return TypeFormatCache::format(TypeFormatCache::Spelling::Vue, type, pointerType.getAsOpaquePtr(), ignorePointerType ? TypeFormatCache::IgnorePointerType : 0, [&]() {
+    return formatTypeUncached(type, pointerType, ignorePointerType);
+  });
+}
+
+string VueComponentFormatter::formatTypeUncached(const Type& type, const clang::QualType pointerType, const bool ignorePointerType) const
 {
   string typeStr = "";
   
@@ -208,7 +225,7 @@ string VueComponentFormatter::formatType(const Type& type, const clang::QualType
   return Type::lookupApiNotes(typeStr);
 }
 
-string VueComponentFormatter::formatTypeAnonymous(const Type& type, const clang::QualType pointerType) {
+string VueComponentFormatter::formatTypeAnonymous(const Type& type, const clang::QualType pointerType) const {
   string output;
   
   output += "{ ";
@@ -224,7 +241,7 @@ string VueComponentFormatter::formatTypeAnonymous(const Type& type, const clang:
   return output;
 }
 
-void VueComponentFormatter::findAndReplaceIn2(string& str, string searchFor, string replaceBy)
+void VueComponentFormatter::findAndReplaceIn2(string& str, string searchFor, string replaceBy) const
 {
   size_t found = str.find(searchFor);
   while (found != string::npos) {
@@ -233,9 +250,9 @@ void VueComponentFormatter::findAndReplaceIn2(string& str, string searchFor, str
   };
 }
 
-string VueComponentFormatter::formatTypeInterface(const Type& type, const clang::QualType pointerQualType) {
+string VueComponentFormatter::formatTypeInterface(const Type& type, const clang::QualType pointerQualType) const {
   if (type.is(TypeType::TypeBridgedInterface) && type.as<BridgedInterfaceType>().isId()) {
-    return formatType(IdType(), pointerQualType);
+    return formatTypeUncached(IdType(), pointerQualType);
   }
   
   string pointerQualTypeStr = pointerQualType.getAsString();
@@ -399,14 +416,14 @@ string VueComponentFormatter::formatTypeInterface(const Type& type, const clang:
 //  return out;
 }
 
-string VueComponentFormatter::getFunctionProto(const vector<Type*>& signature, const clang::QualType qualType)
+string VueComponentFormatter::getFunctionProto(const vector<Type*>& signature, const clang::QualType qualType) const
 {
   ostringstream output;
   output << "JSManagedValue";
   return output.str();
 }
 
-string VueComponentFormatter::getTypeString(clang::ASTContext &Ctx, clang::Decl::ObjCDeclQualifier Quals, clang::QualType qualType, const Type& type, const bool isFuncParam) {
+string VueComponentFormatter::getTypeString(clang::ASTContext &Ctx, clang::Decl::ObjCDeclQualifier Quals, clang::QualType qualType, const Type& type, const bool isFuncParam) const {
   clang::QualType pointerType = Ctx.getUnqualifiedObjCPointerType(qualType);
   
   if (pointerType.getAsString().find("instancetype ", 0) != string::npos) {
@@ -436,13 +453,13 @@ string VueComponentFormatter::getTypeString(clang::ASTContext &Ctx, clang::Decl:
   }
   
   if (formattedOut == "") {
-    cerr << "No type string found for " << pointerType.getAsString() << " - " << qualType.getAsString() << endl;
+    OutputScheduler::err() << "No type string found for " << pointerType.getAsString() << " - " << qualType.getAsString() << endl;
   }
   
   return formattedOut;
 }
 
-string VueComponentFormatter::getInstanceParamsStr(MethodMeta* method, BaseClassMeta* owner, bool forCall) {
+string VueComponentFormatter::getInstanceParamsStr(MethodMeta* method, BaseClassMeta* owner, bool forCall) const {
   vector<string> argumentLabels = method->argLabels;
   
   string output = "";
@@ -475,7 +492,7 @@ string VueComponentFormatter::getInstanceParamsStr(MethodMeta* method, BaseClass
           paramName = argumentLabels[i];
         }
         else if (i < parameters.size()) {
-          cerr << "Warning: fell back to param label instead of argument label for " << method->name << endl;
+          OutputScheduler::err() << "Warning: fell back to param label instead of argument label for " << method->name << endl;
           paramName = parameters[i]->getNameAsString();
         }
       }
@@ -486,7 +503,7 @@ string VueComponentFormatter::getInstanceParamsStr(MethodMeta* method, BaseClass
         paramName = argumentLabels[idxToLookForName];
       }
       else {
-        cerr << methodDecl.getNameAsString() << " - tried to get label out of bounds!\n";
+        OutputScheduler::err() << methodDecl.getNameAsString() << " - tried to get label out of bounds!\n";
       }
       
       paramLabel = paramName;
@@ -10,22 +10,25 @@
 #include <unordered_set>
 
 namespace TypeScript {
+// Holds no state, so the shared instance can be used by writers running in parallel
 class VueComponentFormatter {
 public:
-  static VueComponentFormatter current;
-  static std::map<std::string, bool> nativeTypes;
-  std::vector<std::string> split2(std::string const &input);
-  std::string formatTypeId(const ::Meta::IdType& idType, const clang::QualType pointerType, const bool ignorePointerType = false);
-  std::string formatTypePointer(const ::Meta::PointerType& pointerType, const clang::QualType pointerQualType, const bool ignorePointerType = false);
-  std::string formatTypeInterface(const ::Meta::Type& type, const clang::QualType pointerType);
-  std::string formatTypeAnonymous(const ::Meta::Type& type, const clang::QualType pointerType);
-  std::string formatType(const ::Meta::Type& type, const clang::QualType pointerType, const bool ignorePointerType = false);
-  std::string getFunctionProto(const std::vector<::Meta::Type*>& signature, const clang::QualType qualType);
-  std::string getDefinitiveSelector(::Meta::MethodMeta* meta);
-  std::string getInstanceParamsStr(MethodMeta* meta, BaseClassMeta* owner, bool forConstructor = false);
-  std::string getTypeString(clang::ASTContext &Ctx, clang::Decl::ObjCDeclQualifier Quals, clang::QualType T, const Type& type, const bool isFuncParam = false);
-  std::string vuePropifyTypeName(const std::string& jsName);
-  void findAndReplaceIn2(std::string& str, std::string searchFor, std::string replaceBy);
+  static const VueComponentFormatter current;
+  static const std::map<std::string, bool> nativeTypes;
+  static bool isNativeType(const std::string& typeName);
+  std::vector<std::string> split2(std::string const &input) const;
+  std::string formatTypeId(const ::Meta::IdType& idType, const clang::QualType pointerType, const bool ignorePointerType = false) const;
+  std::string formatTypePointer(const ::Meta::PointerType& pointerType, const clang::QualType pointerQualType, const bool ignorePointerType = false) const;
+  std::string formatTypeInterface(const ::Meta::Type& type, const clang::QualType pointerType) const;
+  std::string formatTypeAnonymous(const ::Meta::Type& type, const clang::QualType pointerType) const;
+  std::string formatType(const ::Meta::Type& type, const clang::QualType pointerType, const bool ignorePointerType = false) const;
+  std::string formatTypeUncached(const ::Meta::Type& type, const clang::QualType pointerType, const bool ignorePointerType = false) const;
+  std::string getFunctionProto(const std::vector<::Meta::Type*>& signature, const clang::QualType qualType) const;
+  std::string getDefinitiveSelector(::Meta::MethodMeta* meta) const;
+  std::string getInstanceParamsStr(MethodMeta* meta, BaseClassMeta* owner, bool forConstructor = false) const;
+  std::string getTypeString(clang::ASTContext &Ctx, clang::Decl::ObjCDeclQualifier Quals, clang::QualType T, const Type& type, const bool isFuncParam = false) const;
+  std::string vuePropifyTypeName(const std::string& jsName) const;
+  void findAndReplaceIn2(std::string& str, std::string searchFor, std::string replaceBy) const;
 
 private:
 };
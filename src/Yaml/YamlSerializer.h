@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MetaYamlTraits.h"
+#include "TypeScript/OutputFiles.h"
 #include <llvm/Support/FileSystem.h>
 #include <string>
 
@@ -10,13 +11,13 @@ public:
     template <class T>
     static void serialize(std::string outputFilePath, T& object)
     {
-        std::error_code errorCode;
-        llvm::raw_fd_ostream fileStream(outputFilePath, errorCode, llvm::sys::fs::OpenFlags::F_None);
+        std::string content;
+        llvm::raw_string_ostream stringStream(content);
+        llvm::yaml::Output output(stringStream);
+        output << object;
+        std::error_code errorCode = TypeScript::OutputFiles::write(outputFilePath, stringStream.str());
         if (errorCode)
             throw std::runtime_error(std::string("Unable to open file ") + outputFilePath + ".");
-        llvm::yaml::Output output(fileStream);
-        output << object;
-        fileStream.close();
     }
 };
 }
@@ -25,6 +25,7 @@ llvm::cl::opt<string> cla_outputUmbrellaHeaderFile("output-umbrella", llvm::cl::
 llvm::cl::opt<string> cla_inputUmbrellaHeaderFile("input-umbrella", llvm::cl::desc("Specify the input umbrella header file"), llvm::cl::value_desc("file_path"));
 llvm::cl::opt<string> cla_blockListModuleRegexesFile("blocklist-modules-file", llvm::cl::desc("Specify the metadata entries blocklist file containing regexes of module names on each line"), llvm::cl::value_desc("file_path"));
 llvm::cl::opt<string> cla_whiteListModuleRegexesFile("whitelist-modules-file", llvm::cl::desc("Specify the metadata entries whitelist file containing regexes of module names on each line"), llvm::cl::value_desc("file_path"));
+llvm::cl::opt<string> cla_exceptionalMetasFile("exceptional-metas-file", llvm::cl::desc("Specify a file with additional fix-up rules for specific declarations, one '<interface|protocol|category> <module> <symbol> <action> <member> [ios-only]' rule per line"), llvm::cl::value_desc("file_path"));
 llvm::cl::opt<bool>   cla_applyManualDtsChanges("apply-manual-dts-changes", llvm::cl::desc("Specify whether to disable manual adjustments to generated .d.ts files for specific erroneous cases in the iOS SDK"), llvm::cl::init(true));
 llvm::cl::opt<string> cla_clangArgumentsDelimiter(llvm::cl::Positional, llvm::cl::desc("Xclang"), llvm::cl::init("-"));
 llvm::cl::list<string> cla_clangArguments(llvm::cl::ConsumeAfter, llvm::cl::desc("<clang arguments>..."));
@@ -123,6 +124,9 @@ void run(int argc, const char** argv, char **envp)
   assert(cla_clangArgumentsDelimiter.getValue() == "Xclang");
   
   TypeScript::JSExportDefinitionWriter::outputJSEFolder = cla_outputJSEFolder.getValue();
+  TypeScript::JSExportDefinitionWriter::perFramework = cla_jsexportPerFramework;
+  TypeScript::JSExportDefinitionWriter::maxFileSize = cla_jsexportMaxFileSize;
+  TypeScript::JSExportDefinitionWriter::inheritExports = cla_jsexportInheritance;
   TypeScript::VueComponentDefinitionWriter::outputVueFolder = cla_outputVueFolder.getValue();
   
   dumpArgs(cout, argc, argv, envp);
@@ -175,7 +179,8 @@ void run(int argc, const char** argv, char **envp)
   }
 
   Meta::ModulesBlocklist modulesBlocklist(cla_whiteListModuleRegexesFile, cla_blockListModuleRegexesFile);
-  clang::tooling::runToolOnCodeWithArgs(new MetaGenerationFrontendAction(/*r*/modulesBlocklist), umbrellaContent, clangArgs, "umbrella.h", "objc-metadata-generator");
+  Meta::ExceptionalMetasRules exceptionalMetasRules(cla_exceptionalMetasFile);
+  clang::tooling::runToolOnCodeWithArgs(new MetaGenerationFrontendAction(/*r*/modulesBlocklist, /*r*/exceptionalMetasRules), umbrellaContent, clangArgs, "umbrella.h", "objc-metadata-generator");
   
   clock_t end = clock();
   double elapsed_secs = double(end - begin) / CLOCKS_PER_SEC;